@@ -0,0 +1,191 @@
+#include "rusty/collections/min_heap.h"
+
+#include <benchmark/benchmark.h>
+#include <queue>
+#include <random>
+#include <string>
+
+namespace {
+
+// The recursive swap-based MinHeap before the hole-based sift, kept as a
+// baseline.
+template <typename T, typename Compare = std::less<T>>
+class RecursiveMinHeap {
+public:
+	explicit RecursiveMinHeap(std::vector<T> v) : v_(std::move(v)) {
+		for (ssize_t i = v_.size() / 2 - 1; i >= 0; --i) {
+			heapify_subtree(i);
+		}
+	}
+	rusty::Option<T> pop() {
+		if (v_.empty()) {
+			return rusty::None;
+		}
+		rusty::Option<T> ret = std::move(v_[0]);
+		if (v_.size() > 1) {
+			v_[0] = std::move(v_.back());
+		}
+		v_.pop_back();
+		if (!v_.empty()) {
+			heapify_subtree(0);
+		}
+		return ret;
+	}
+
+private:
+	void heapify_subtree(size_t i) {
+		size_t smallest = i;
+		size_t left = (i << 1) + 1;
+		if (left < v_.size() && cmp_(v_[left], v_[smallest])) {
+			smallest = left;
+		}
+		size_t right = (i << 1) + 2;
+		if (right < v_.size() && cmp_(v_[right], v_[smallest])) {
+			smallest = right;
+		}
+		if (smallest == i) {
+			return;
+		}
+		std::swap(v_[i], v_[smallest]);
+		heapify_subtree(smallest);
+	}
+
+	std::vector<T> v_;
+	Compare cmp_;
+};
+
+template <typename T>
+std::vector<T> make_data(size_t n);
+
+template <>
+std::vector<int> make_data(size_t n) {
+	std::mt19937 rng(233);
+	std::vector<int> v;
+	for (size_t i = 0; i < n; ++i) {
+		v.push_back(rng());
+	}
+	return v;
+}
+
+template <>
+std::vector<std::string> make_data(size_t n) {
+	std::mt19937 rng(233);
+	std::vector<std::string> v;
+	for (size_t i = 0; i < n; ++i) {
+		// Long enough to defeat the small string optimization.
+		v.push_back(std::string(24, 'k') + std::to_string(rng()));
+	}
+	return v;
+}
+
+template <typename T>
+void BM_MinHeapPopAll(benchmark::State &state) {
+	auto data = make_data<T>(state.range(0));
+	for (auto _ : state) {
+		auto heap = rusty::MakeMinHeap(data);
+		for (;;) {
+			auto ret = heap.pop();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_MinHeapPopAll, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_MinHeapPopAll, std::string)->Range(1 << 10, 1 << 18);
+
+template <size_t Arity>
+void BM_MinHeapArityPopAll(benchmark::State &state) {
+	auto data = make_data<int>(state.range(0));
+	for (auto _ : state) {
+		auto heap = rusty::MakeMinHeap<Arity>(data);
+		for (;;) {
+			auto ret = heap.pop();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_MinHeapArityPopAll, 2)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_MinHeapArityPopAll, 4)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_MinHeapArityPopAll, 8)->Range(1 << 10, 1 << 22);
+
+template <typename T>
+void BM_RecursiveMinHeapPopAll(benchmark::State &state) {
+	auto data = make_data<T>(state.range(0));
+	for (auto _ : state) {
+		RecursiveMinHeap<T> heap(data);
+		for (;;) {
+			auto ret = heap.pop();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_RecursiveMinHeapPopAll, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_RecursiveMinHeapPopAll, std::string)
+	->Range(1 << 10, 1 << 18);
+
+template <typename T>
+void BM_PriorityQueuePopAll(benchmark::State &state) {
+	auto data = make_data<T>(state.range(0));
+	for (auto _ : state) {
+		std::priority_queue<T, std::vector<T>, std::greater<T>> q(
+			std::greater<T>(), data
+		);
+		while (!q.empty()) {
+			benchmark::DoNotOptimize(q.top());
+			q.pop();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PriorityQueuePopAll, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PriorityQueuePopAll, std::string)
+	->Range(1 << 10, 1 << 18);
+
+// Keeps the heap at range(0) elements, replacing the minimum each iteration.
+template <typename T>
+void BM_MinHeapPushPop(benchmark::State &state) {
+	auto data = make_data<T>(state.range(0) * 2);
+	std::vector<T> init(data.begin(), data.begin() + state.range(0));
+	auto heap = rusty::MakeMinHeap(std::move(init));
+	size_t i = 0;
+	for (auto _ : state) {
+		heap.push(data[i]);
+		benchmark::DoNotOptimize(heap.pop());
+		i = i + 1 == data.size() ? 0 : i + 1;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_MinHeapPushPop, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_MinHeapPushPop, std::string)->Range(1 << 10, 1 << 18);
+
+template <typename T>
+void BM_PriorityQueuePushPop(benchmark::State &state) {
+	auto data = make_data<T>(state.range(0) * 2);
+	std::priority_queue<T, std::vector<T>, std::greater<T>> heap(
+		data.begin(), data.begin() + state.range(0)
+	);
+	size_t i = 0;
+	for (auto _ : state) {
+		heap.push(data[i]);
+		benchmark::DoNotOptimize(heap.top());
+		heap.pop();
+		i = i + 1 == data.size() ? 0 : i + 1;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PriorityQueuePushPop, int)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PriorityQueuePushPop, std::string)
+	->Range(1 << 10, 1 << 18);
+
+} // namespace
@@ -0,0 +1,41 @@
+#include "rusty/intrinsics.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Updates a high-water mark that rarely changes, as with a peak queue depth.
+template <std::memory_order kOrder>
+void BM_AtomicMax(benchmark::State &state) {
+	static std::atomic<uint64_t> high(0);
+	uint64_t x = state.thread_index();
+	for (auto _ : state) {
+		x = x * 6364136223846793005 + 1442695040888963407;
+		rusty::intrinsics::atomic_max(high, x >> 40, kOrder);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AtomicMax, std::memory_order_seq_cst)
+	->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AtomicMax, std::memory_order_relaxed)
+	->ThreadRange(1, 16)->UseRealTime();
+
+void BM_AtomicCounter(benchmark::State &state) {
+	static std::atomic<uint64_t> counter(0);
+	for (auto _ : state) {
+		counter.fetch_add(1, std::memory_order_relaxed);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicCounter)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_ShardedCounter(benchmark::State &state) {
+	static rusty::intrinsics::ShardedCounter counter;
+	for (auto _ : state) {
+		counter.add(1);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedCounter)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
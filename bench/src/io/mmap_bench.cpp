@@ -0,0 +1,79 @@
+#include "rusty/io/mmap.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kRecords = 1 << 22;
+
+// A file of "kRecords" uint64_t, removed on destruction.
+class RecordFile {
+public:
+	RecordFile() {
+		path_ = "/tmp/rusty-mmap-bench-XXXXXX";
+		int fd = mkstemp(path_.data());
+		std::vector<uint64_t> v(kRecords);
+		for (size_t i = 0; i < kRecords; ++i) {
+			v[i] = i;
+		}
+		if (write(fd, v.data(), v.size() * sizeof(uint64_t)) < 0) {
+			abort();
+		}
+		close(fd);
+	}
+	~RecordFile() {
+		unlink(path_.c_str());
+	}
+	const std::string &path() const {
+		return path_;
+	}
+
+private:
+	std::string path_;
+};
+
+void BM_MmapRecords(benchmark::State &state) {
+	RecordFile file;
+	for (auto _ : state) {
+		auto m = rusty::io::Mmap::open(file.path()).unwrap();
+		auto iter = m.records<uint64_t>();
+		uint64_t sum = 0;
+		for (;;) {
+			auto ret = iter.next();
+			if (ret.is_none()) {
+				break;
+			}
+			sum += std::move(ret).unwrap_unchecked().deref();
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * kRecords * sizeof(uint64_t));
+}
+BENCHMARK(BM_MmapRecords)->Unit(benchmark::kMillisecond);
+
+// Baseline: buffered reads that copy the records into a vector.
+void BM_FreadRecords(benchmark::State &state) {
+	RecordFile file;
+	std::vector<uint64_t> buf(1 << 14);
+	for (auto _ : state) {
+		FILE *f = fopen(file.path().c_str(), "rb");
+		uint64_t sum = 0;
+		for (;;) {
+			size_t n = fread(buf.data(), sizeof(uint64_t), buf.size(), f);
+			if (n == 0) {
+				break;
+			}
+			for (size_t i = 0; i < n; ++i) {
+				sum += buf[i];
+			}
+		}
+		fclose(f);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * kRecords * sizeof(uint64_t));
+}
+BENCHMARK(BM_FreadRecords)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,121 @@
+#include "rusty/iter/adapters.h"
+
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+// Adapter chains against the equivalent hand-written loops.
+
+namespace {
+
+constexpr size_t kLen = 1 << 16;
+
+std::vector<int> make_data() {
+	std::vector<int> a(kLen);
+	std::iota(a.begin(), a.end(), 0);
+	return a;
+}
+
+void BM_FilterMapSumLoop(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		int64_t sum = 0;
+		for (int x : a) {
+			if (x % 3 == 0) {
+				sum += (int64_t)x * x;
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_FilterMapSumLoop);
+
+void BM_FilterMapSumAdapters(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		int64_t sum = rusty::fold(
+			rusty::MakeMap(
+				rusty::MakeFilter(
+					rusty::slice::MakeIter(a),
+					[](rusty::Ref<const int> x) { return x.deref() % 3 == 0; }
+				),
+				[](rusty::Ref<const int> x) {
+					return (int64_t)x.deref() * x.deref();
+				}
+			),
+			(int64_t)0,
+			[](int64_t acc, int64_t x) { return acc + x; }
+		);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_FilterMapSumAdapters);
+
+// The same chain over a trait object, i.e., boxing every stage.
+void BM_FilterMapSumDyn(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto filtered = rusty::NewIterator(rusty::MakeFilter(
+			rusty::slice::MakeIter(a),
+			[](rusty::Ref<const int> x) { return x.deref() % 3 == 0; }
+		));
+		auto mapped = rusty::NewIterator(rusty::MakeMap(
+			std::move(filtered),
+			[](rusty::Ref<const int> x) {
+				return (int64_t)x.deref() * x.deref();
+			}
+		));
+		int64_t sum = rusty::fold(
+			std::move(mapped), (int64_t)0,
+			[](int64_t acc, int64_t x) { return acc + x; }
+		);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_FilterMapSumDyn);
+
+void BM_ZipEnumerateLoop(benchmark::State &state) {
+	auto a = make_data();
+	auto b = make_data();
+	for (auto _ : state) {
+		int64_t sum = 0;
+		for (size_t i = 1; i < kLen / 2; ++i) {
+			sum += (int64_t)i * a[i] + b[i - 1];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen / 2);
+}
+BENCHMARK(BM_ZipEnumerateLoop);
+
+// The whole chain is over slices, so for_each checks the length once and
+// takes the next_unchecked path.
+void BM_ZipEnumerateAdapters(benchmark::State &state) {
+	auto a = make_data();
+	auto b = make_data();
+	for (auto _ : state) {
+		int64_t sum = 0;
+		rusty::for_each(
+			rusty::MakeZip(
+				rusty::MakeTake(
+					rusty::MakeSkip(
+						rusty::MakeEnumerate(rusty::slice::MakeIter(a)), 1
+					),
+					kLen / 2 - 1
+				),
+				rusty::slice::MakeIter(b)
+			),
+			[&sum](auto x) {
+				sum += (int64_t)x.first.first * x.first.second.deref() +
+					x.second.deref();
+			}
+		);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen / 2);
+}
+BENCHMARK(BM_ZipEnumerateAdapters);
+
+} // namespace
@@ -0,0 +1,219 @@
+#include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
+
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+// Overhead of the iterator abstractions over a raw loop, and of dynamic
+// dispatch through trait objects over static dispatch.
+
+namespace {
+
+constexpr size_t kLen = 1 << 16;
+
+std::vector<int> make_data() {
+	std::vector<int> a(kLen);
+	std::iota(a.begin(), a.end(), 0);
+	return a;
+}
+
+template <typename I>
+int sum_by_next(I &iter) {
+	int sum = 0;
+	for (;;) {
+		auto ret = iter.next();
+		if (ret.is_none()) {
+			break;
+		}
+		sum += std::move(ret).unwrap_unchecked().deref();
+	}
+	return sum;
+}
+
+void BM_SumRawLoop(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		int sum = 0;
+		for (int x : a) {
+			sum += x;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumRawLoop);
+
+void BM_SumSliceIterStatic(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::slice::MakeIter(a);
+		benchmark::DoNotOptimize(sum_by_next(iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumSliceIterStatic);
+
+void BM_SumSliceIterDyn(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::NewIterator(rusty::slice::MakeIter(a));
+		benchmark::DoNotOptimize(sum_by_next(*iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumSliceIterDyn);
+
+void BM_SumPeekableStatic(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::MakePeekable(rusty::slice::MakeIter(a));
+		benchmark::DoNotOptimize(sum_by_next(iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumPeekableStatic);
+
+void BM_SumPeekableDyn(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(a))
+		);
+		benchmark::DoNotOptimize(sum_by_next(*iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumPeekableDyn);
+
+// The access pattern of a merge: peek, then advance.
+template <typename I>
+int sum_by_peek(I &iter) {
+	int sum = 0;
+	for (;;) {
+		auto peeked = iter.peek();
+		if (peeked == nullptr) {
+			break;
+		}
+		sum += peeked->deref();
+		iter.next();
+	}
+	return sum;
+}
+
+void BM_PeekNextStatic(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::MakePeekable(rusty::slice::MakeIter(a));
+		benchmark::DoNotOptimize(sum_by_peek(iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_PeekNextStatic);
+
+void BM_PeekNextDyn(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto iter = rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(a))
+		);
+		benchmark::DoNotOptimize(sum_by_peek(*iter));
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_PeekNextDyn);
+
+void BM_CollectIntoStatic(benchmark::State &state) {
+	auto a = make_data();
+	std::vector<rusty::Ref<const int>> out;
+	for (auto _ : state) {
+		out.clear();
+		rusty::collect_into(rusty::slice::MakeIter(a), out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CollectIntoStatic);
+
+void BM_CollectIntoDyn(benchmark::State &state) {
+	auto a = make_data();
+	std::vector<rusty::Ref<const int>> out;
+	for (auto _ : state) {
+		out.clear();
+		rusty::collect_into(
+			rusty::NewIterator(rusty::slice::MakeIter(a)), out
+		);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CollectIntoDyn);
+
+// Into a new vector each time, which size_hint lets collect_into allocate
+// once.
+void BM_CollectIntoFresh(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		std::vector<rusty::Ref<const int>> out;
+		rusty::collect_into(
+			rusty::NewIterator(rusty::slice::MakeIter(a)), out
+		);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CollectIntoFresh);
+
+// Collecting the values of a slice, by copying batches or one by one.
+void BM_CollectCopied(benchmark::State &state) {
+	auto a = make_data();
+	std::vector<int> out;
+	for (auto _ : state) {
+		out.clear();
+		rusty::collect_into(rusty::slice::MakeIter(a).copied(), out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CollectCopied);
+
+void BM_CollectCopiedByNext(benchmark::State &state) {
+	auto a = make_data();
+	std::vector<int> out;
+	for (auto _ : state) {
+		out.clear();
+		auto iter = rusty::slice::MakeIter(a);
+		for (;;) {
+			auto ret = iter.next();
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked().deref());
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CollectCopiedByNext);
+
+// Summing chunk by chunk lets the inner loop vectorize.
+void BM_SumChunks(benchmark::State &state) {
+	auto a = make_data();
+	for (auto _ : state) {
+		auto chunks = rusty::slice::MakeIter(a).chunks(256);
+		int sum = 0;
+		for (;;) {
+			auto chunk = chunks.next();
+			if (chunk.is_none()) {
+				break;
+			}
+			for (int x : *chunk.as_ptr()) {
+				sum += x;
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_SumChunks);
+
+} // namespace
@@ -0,0 +1,60 @@
+#include "rusty/iter/external_sort.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace {
+
+constexpr size_t kTotal = 1 << 22;
+
+std::vector<uint64_t> make_input() {
+	std::mt19937_64 rng(233);
+	std::vector<uint64_t> v(kTotal);
+	for (auto &x : v) {
+		x = rng();
+	}
+	return v;
+}
+
+// range(0) is the number of items kept in memory.
+void BM_ExternalSort(benchmark::State &state) {
+	auto input = make_input();
+	for (auto _ : state) {
+		rusty::ExternalSorter<uint64_t> sorter(state.range(0));
+		for (uint64_t x : input) {
+			if (sorter.push(x).is_err()) {
+				state.SkipWithError("push failed");
+				return;
+			}
+		}
+		state.counters["runs"] = sorter.spilled_runs() + 1;
+		auto iter = std::move(sorter).finish().unwrap();
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_ExternalSort)
+	->RangeMultiplier(8)
+	->Range(1 << 12, 1 << 18)
+	->Unit(benchmark::kMillisecond);
+
+// In-memory baseline.
+void BM_StdSort(benchmark::State &state) {
+	auto input = make_input();
+	for (auto _ : state) {
+		auto v = input;
+		std::sort(v.begin(), v.end());
+		benchmark::DoNotOptimize(v.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_StdSort)->Unit(benchmark::kMillisecond);
+
+} // namespace
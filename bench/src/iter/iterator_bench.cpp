@@ -0,0 +1,51 @@
+#include "rusty/iter/iterator.h"
+
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+namespace {
+
+constexpr size_t kLen = 1 << 16;
+
+void BM_IteratorNext(benchmark::State &state) {
+	std::vector<int> a(kLen);
+	std::iota(a.begin(), a.end(), 0);
+	for (auto _ : state) {
+		auto iter = rusty::NewIterator(rusty::slice::MakeIter(a));
+		int sum = 0;
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			sum += std::move(ret).unwrap_unchecked().deref();
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_IteratorNext);
+
+void BM_IteratorNextBatch(benchmark::State &state) {
+	std::vector<int> a(kLen);
+	std::iota(a.begin(), a.end(), 0);
+	std::vector<rusty::Ref<const int>> buf;
+	for (auto _ : state) {
+		auto iter = rusty::NewIterator(rusty::slice::MakeIter(a));
+		int sum = 0;
+		for (;;) {
+			buf.clear();
+			if (iter->next_batch(buf, state.range(0)) == 0) {
+				break;
+			}
+			for (auto x : buf) {
+				sum += x.deref();
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_IteratorNextBatch)->RangeMultiplier(4)->Range(1, 1024);
+
+} // namespace
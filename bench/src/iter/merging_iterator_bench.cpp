@@ -0,0 +1,274 @@
+#include "rusty/iter/adapters.h"
+#include "rusty/iter/loser_tree_merging_iterator.h"
+#include "rusty/iter/merging_iterator.h"
+#include "rusty/iter/reducing_merging_iterator.h"
+#include "rusty/iter/seekable_merging_iterator.h"
+#include "rusty/iter/static_merging_iterator.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr size_t kTotal = 1 << 18;
+
+template <typename T>
+T make_element(std::mt19937 &rng, size_t size);
+template <>
+int make_element(std::mt19937 &rng, size_t) {
+	return rng();
+}
+// Random keys of "size" bytes that share a common prefix, as in sorted runs
+// of an LSM-tree.
+template <>
+std::string make_element(std::mt19937 &rng, size_t size) {
+	std::string key = std::to_string(rng());
+	return std::string(size - std::min(size, key.size()), 'k') + key;
+}
+
+template <typename T>
+std::vector<std::vector<T>> make_runs(size_t k, size_t size) {
+	std::mt19937 rng(233);
+	std::vector<std::vector<T>> runs(k);
+	for (size_t i = 0; i < kTotal; ++i) {
+		runs[rng() % k].push_back(make_element<T>(rng, size));
+	}
+	for (auto &run : runs) {
+		std::sort(run.begin(), run.end());
+	}
+	return runs;
+}
+
+template <typename T>
+std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const T>>>> make_iters(
+	const std::vector<std::vector<T>> &runs
+) {
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const T>>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run))
+		));
+	}
+	return iters;
+}
+
+// range(0) is the number of runs, range(1) is the size of string keys.
+template <typename T, typename NewMerging>
+void merge(benchmark::State &state, NewMerging new_merging) {
+	auto runs = make_runs<T>(state.range(0), state.range(1));
+	for (auto _ : state) {
+		auto iter = new_merging(make_iters(runs));
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+
+template <typename T>
+void BM_MergingIteratorHeap(benchmark::State &state) {
+	merge<T>(state, [](auto iters) {
+		return rusty::NewMergingIterator(std::move(iters));
+	});
+}
+BENCHMARK_TEMPLATE(BM_MergingIteratorHeap, int)
+	->ArgsProduct({benchmark::CreateRange(2, 1024, 2), {4}});
+BENCHMARK_TEMPLATE(BM_MergingIteratorHeap, std::string)
+	->ArgsProduct({benchmark::CreateRange(2, 256, 4), {16, 64, 256}});
+
+void BM_MergingIteratorHeapPrefixKey(benchmark::State &state) {
+	using Key = rusty::Ref<const std::string>;
+	merge<std::string>(state, [](auto iters) {
+		return rusty::NewMergingIterator(
+			std::move(iters),
+			rusty::MakePrefixKeyCompare<Key>([](const Key &key) {
+				return rusty::string_prefix_key(key.deref());
+			})
+		);
+	});
+}
+BENCHMARK(BM_MergingIteratorHeapPrefixKey)
+	->ArgsProduct({benchmark::CreateRange(2, 256, 4), {16, 64, 256}});
+
+// Descending merge of the same runs, to compare with BM_MergingIteratorHeap.
+void BM_MergingIteratorHeapReverse(benchmark::State &state) {
+	auto runs = make_runs<int>(state.range(0), 4);
+	for (auto _ : state) {
+		std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+		for (const auto &run : runs) {
+			iters.push_back(rusty::NewPeek(rusty::MakePeekable(
+				rusty::MakeRev(rusty::slice::MakeIter(run))
+			)));
+		}
+		auto iter = rusty::NewReverseMergingIterator(std::move(iters));
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_MergingIteratorHeapReverse)->RangeMultiplier(8)->Range(2, 512);
+
+template <typename T>
+void BM_MergingIteratorLoserTree(benchmark::State &state) {
+	merge<T>(state, [](auto iters) {
+		return rusty::NewLoserTreeMergingIterator(std::move(iters));
+	});
+}
+BENCHMARK_TEMPLATE(BM_MergingIteratorLoserTree, int)
+	->ArgsProduct({benchmark::CreateRange(2, 1024, 2), {4}});
+BENCHMARK_TEMPLATE(BM_MergingIteratorLoserTree, std::string)
+	->ArgsProduct({benchmark::CreateRange(2, 256, 4), {16, 64, 256}});
+
+// Runs whose keys are duplicated about 4 times in total, as in a compaction of
+// overlapping runs of an LSM-tree.
+std::vector<std::vector<int>> make_overlapping_runs(size_t k) {
+	std::mt19937 rng(233);
+	std::vector<std::vector<int>> runs(k);
+	for (size_t i = 0; i < kTotal; ++i) {
+		runs[rng() % k].push_back(rng() % (kTotal / 4));
+	}
+	for (auto &run : runs) {
+		std::sort(run.begin(), run.end());
+	}
+	return runs;
+}
+
+// Merges, and then keeps the first of each group of equal keys in a second
+// pass, as the baseline of BM_MergingIteratorReducing.
+void BM_MergingIteratorThenDedup(benchmark::State &state) {
+	auto runs = make_overlapping_runs(state.range(0));
+	for (auto _ : state) {
+		auto iter = rusty::NewMergingIterator(make_iters(runs));
+		rusty::Option<rusty::Ref<const int>> last;
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			if (last.is_some() && *last.as_ptr() == *ret.as_ptr()) {
+				continue;
+			}
+			last = std::move(ret);
+			benchmark::DoNotOptimize(last);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_MergingIteratorThenDedup)->RangeMultiplier(8)->Range(2, 512);
+
+void BM_MergingIteratorReducing(benchmark::State &state) {
+	auto runs = make_overlapping_runs(state.range(0));
+	for (auto _ : state) {
+		auto iter = rusty::NewReducingMergingIterator(make_iters(runs));
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_MergingIteratorReducing)->RangeMultiplier(8)->Range(2, 512);
+
+constexpr size_t kScans = 64;
+constexpr size_t kScanLen = 16;
+
+// The keys of make_runs<int> are uniform in the range of int.
+int scan_start(size_t i) {
+	return static_cast<int>(
+		std::numeric_limits<int>::min() + (int64_t(1) << 32) / kScans * i
+	);
+}
+
+// Range scans of "kScanLen" items at increasing keys, restarting the merge
+// and draining up to the start of every range, as the baseline of
+// BM_SeekableMergingIteratorRangeScan.
+void BM_MergingIteratorRangeScanRestart(benchmark::State &state) {
+	auto runs = make_runs<int>(state.range(0), 4);
+	for (auto _ : state) {
+		for (size_t i = 0; i < kScans; ++i) {
+			int start = scan_start(i);
+			auto iter = rusty::NewMergingIterator(make_iters(runs));
+			size_t n = 0;
+			while (n < kScanLen) {
+				auto ret = iter->next();
+				if (ret.is_none()) {
+					break;
+				}
+				if (ret.as_ptr()->deref() >= start) {
+					benchmark::DoNotOptimize(ret);
+					++n;
+				}
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kScans * kScanLen);
+}
+BENCHMARK(BM_MergingIteratorRangeScanRestart)->RangeMultiplier(8)->Range(2, 512);
+
+void BM_SeekableMergingIteratorRangeScan(benchmark::State &state) {
+	using Ref = rusty::Ref<const int>;
+	auto runs = make_runs<int>(state.range(0), 4);
+	for (auto _ : state) {
+		std::vector<std::unique_ptr<rusty::Seek<Ref>>> iters;
+		for (const auto &run : runs) {
+			iters.push_back(rusty::NewSeek(
+				rusty::MakePeekable(rusty::slice::MakeIter(run))
+			));
+		}
+		auto iter = rusty::NewSeekableMergingIterator(std::move(iters));
+		for (size_t i = 0; i < kScans; ++i) {
+			int start = scan_start(i);
+			iter->seek(start);
+			for (size_t n = 0; n < kScanLen; ++n) {
+				auto ret = iter->next();
+				if (ret.is_none()) {
+					break;
+				}
+				benchmark::DoNotOptimize(ret);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kScans * kScanLen);
+}
+BENCHMARK(BM_SeekableMergingIteratorRangeScan)
+	->RangeMultiplier(8)->Range(2, 512);
+
+template <typename T>
+void BM_MergingIteratorStatic(benchmark::State &state) {
+	auto runs = make_runs<T>(state.range(0), state.range(1));
+	for (auto _ : state) {
+		std::vector<rusty::Peekable<rusty::slice::Iter<T>>> iters;
+		for (const auto &run : runs) {
+			iters.push_back(rusty::MakePeekable(rusty::slice::MakeIter(run)));
+		}
+		auto iter = rusty::MakeStaticMergingIterator(std::move(iters));
+		for (;;) {
+			auto ret = iter.next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK_TEMPLATE(BM_MergingIteratorStatic, int)
+	->ArgsProduct({benchmark::CreateRange(2, 1024, 2), {4}});
+BENCHMARK_TEMPLATE(BM_MergingIteratorStatic, std::string)
+	->ArgsProduct({benchmark::CreateRange(2, 256, 4), {16, 64, 256}});
+
+} // namespace
@@ -0,0 +1,59 @@
+#include "rusty/iter/merging_iterator.h"
+#include "rusty/iter/parallel_merge.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace {
+
+constexpr size_t kTotal = 1 << 22;
+constexpr size_t kRuns = 64;
+
+std::vector<std::vector<int>> make_runs() {
+	std::mt19937 rng(233);
+	std::vector<std::vector<int>> runs(kRuns);
+	for (size_t i = 0; i < kTotal; ++i) {
+		runs[rng() % kRuns].push_back(rng());
+	}
+	for (auto &run : runs) {
+		std::sort(run.begin(), run.end());
+	}
+	return runs;
+}
+
+void BM_ParallelMerge(benchmark::State &state) {
+	auto data = make_runs();
+	std::vector<rusty::slice::Iter<int>> runs;
+	for (const auto &run : data) {
+		runs.push_back(rusty::slice::MakeIter(run));
+	}
+	std::vector<int> out;
+	for (auto _ : state) {
+		rusty::parallel_merge_into(runs, out, state.range(0));
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_ParallelMerge)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+// Single-threaded baseline: collect_into from a MergingIterator.
+void BM_ParallelMergeBaseline(benchmark::State &state) {
+	auto data = make_runs();
+	std::vector<rusty::Ref<const int>> out;
+	for (auto _ : state) {
+		std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+		for (const auto &run : data) {
+			iters.push_back(rusty::NewPeek(
+				rusty::MakePeekable(rusty::slice::MakeIter(run))
+			));
+		}
+		out.clear();
+		rusty::collect_into(rusty::NewMergingIterator(std::move(iters)), out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kTotal);
+}
+BENCHMARK(BM_ParallelMergeBaseline)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,75 @@
+#include "rusty/iter/merging_iterator.h"
+#include "rusty/iter/readahead.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr size_t kPerSource = 1 << 14;
+constexpr size_t kSources = 8;
+
+// Yields ascending integers, spending about "work" iterations of busy work
+// per item to mimic decompression.
+class SlowIterator {
+public:
+	using value_type = uint64_t;
+	SlowIterator(uint64_t start, size_t work) : cur_(start), work_(work) {}
+	rusty::Option<value_type> next(
+		rusty::type_tag_t<rusty::Iterator<value_type>>
+	) {
+		if (produced_ == kPerSource) {
+			return rusty::None;
+		}
+		uint64_t x = cur_;
+		for (size_t i = 0; i < work_; ++i) {
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+		}
+		benchmark::DoNotOptimize(x);
+		++produced_;
+		cur_ += kSources;
+		return cur_;
+	}
+
+private:
+	uint64_t cur_;
+	size_t work_;
+	size_t produced_ = 0;
+};
+
+template <typename MakePeek>
+void merge(benchmark::State &state, MakePeek make_peek) {
+	for (auto _ : state) {
+		std::vector<std::unique_ptr<rusty::Peek<uint64_t>>> iters;
+		for (size_t i = 0; i < kSources; ++i) {
+			iters.push_back(make_peek(SlowIterator(i, state.range(0))));
+		}
+		auto iter = rusty::NewMergingIterator(std::move(iters));
+		for (;;) {
+			auto ret = iter->next();
+			if (ret.is_none()) {
+				break;
+			}
+			benchmark::DoNotOptimize(ret);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kPerSource * kSources);
+}
+
+void BM_MergeSlowSources(benchmark::State &state) {
+	merge(state, [](SlowIterator iter) {
+		return rusty::NewPeek(rusty::MakePeekable(std::move(iter)));
+	});
+}
+BENCHMARK(BM_MergeSlowSources)->Arg(0)->Arg(100)->Arg(1000)->UseRealTime();
+
+void BM_MergeSlowSourcesReadahead(benchmark::State &state) {
+	merge(state, [](SlowIterator iter) {
+		return rusty::NewPeek(rusty::MakeReadahead(std::move(iter)));
+	});
+}
+BENCHMARK(BM_MergeSlowSourcesReadahead)
+	->Arg(0)->Arg(100)->Arg(1000)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,98 @@
+#include "rusty/option.h"
+#include "rusty/result.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+// The cost of returning Option/Result from a function that is not inlined,
+// compared to a bool with an out parameter.
+
+namespace {
+
+constexpr size_t kLen = 1 << 12;
+
+enum class DivError {
+	DivideByZero,
+};
+
+__attribute__((noinline)) bool checked_div_raw(int a, int b, int *out) {
+	if (b == 0) {
+		return false;
+	}
+	*out = a / b;
+	return true;
+}
+__attribute__((noinline)) rusty::Option<int> checked_div_option(int a, int b) {
+	if (b == 0) {
+		return rusty::None;
+	}
+	return a / b;
+}
+__attribute__((noinline)) rusty::Result<int, DivError> checked_div_result(
+	int a, int b
+) {
+	if (b == 0) {
+		return DivError::DivideByZero;
+	}
+	return a / b;
+}
+
+// One in 16 divisors is zero.
+std::vector<int> make_divisors() {
+	std::mt19937 rng(233);
+	std::vector<int> v;
+	for (size_t i = 0; i < kLen; ++i) {
+		v.push_back(rng() % 16 == 0 ? 0 : rng() % 100 + 1);
+	}
+	return v;
+}
+
+void BM_CheckedDivRaw(benchmark::State &state) {
+	auto divisors = make_divisors();
+	for (auto _ : state) {
+		int sum = 0;
+		for (int b : divisors) {
+			int q;
+			if (checked_div_raw(1 << 20, b, &q)) {
+				sum += q;
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CheckedDivRaw);
+
+void BM_CheckedDivOption(benchmark::State &state) {
+	auto divisors = make_divisors();
+	for (auto _ : state) {
+		int sum = 0;
+		for (int b : divisors) {
+			auto q = checked_div_option(1 << 20, b);
+			if (q.is_some()) {
+				sum += std::move(q).unwrap_unchecked();
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CheckedDivOption);
+
+void BM_CheckedDivResult(benchmark::State &state) {
+	auto divisors = make_divisors();
+	for (auto _ : state) {
+		int sum = 0;
+		for (int b : divisors) {
+			auto q = checked_div_result(1 << 20, b);
+			if (q.is_ok()) {
+				sum += std::move(q).unwrap_unchecked();
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * kLen);
+}
+BENCHMARK(BM_CheckedDivResult);
+
+} // namespace
@@ -0,0 +1,125 @@
+#include "rusty/sync.h"
+#include "rusty/sync/channel.h"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <thread>
+
+namespace {
+
+constexpr size_t kItems = 1 << 18;
+constexpr size_t kCapacity = 1024;
+
+void BM_SpscChannel(benchmark::State &state) {
+	for (auto _ : state) {
+		auto [tx, rx] = rusty::sync::spsc::channel<uint64_t>(kCapacity);
+		std::thread producer([tx = std::move(tx)]() mutable {
+			for (size_t i = 0; i < kItems; ++i) {
+				tx.send(i).unwrap();
+			}
+		});
+		uint64_t sum = 0;
+		for (;;) {
+			auto ret = rx.recv();
+			if (ret.is_none()) {
+				break;
+			}
+			sum += std::move(ret).unwrap_unchecked();
+		}
+		benchmark::DoNotOptimize(sum);
+		producer.join();
+	}
+	state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_SpscChannel)->UseRealTime();
+
+// range(0) producers and range(0) consumers.
+void BM_MpmcChannel(benchmark::State &state) {
+	size_t n = state.range(0);
+	for (auto _ : state) {
+		auto [tx, rx] = rusty::sync::mpmc::channel<uint64_t>(kCapacity);
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < n; ++i) {
+			threads.emplace_back([i, n, tx = tx.clone()]() mutable {
+				for (size_t j = i; j < kItems; j += n) {
+					tx.send(j).unwrap();
+				}
+			});
+		}
+		{ auto dropped = std::move(tx); }
+		for (size_t i = 0; i < n; ++i) {
+			threads.emplace_back([rx = rx.clone()]() mutable {
+				uint64_t sum = 0;
+				for (;;) {
+					auto ret = rx.recv();
+					if (ret.is_none()) {
+						break;
+					}
+					sum += std::move(ret).unwrap_unchecked();
+				}
+				benchmark::DoNotOptimize(sum);
+			});
+		}
+		for (auto &t : threads) {
+			t.join();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_MpmcChannel)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+// Baseline: a bounded queue behind a Mutex, polled by both sides.
+void BM_MutexDeque(benchmark::State &state) {
+	size_t n = state.range(0);
+	for (auto _ : state) {
+		rusty::sync::Mutex<std::deque<uint64_t>> queue{std::deque<uint64_t>()};
+		std::atomic<size_t> producers{n};
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < n; ++i) {
+			threads.emplace_back([&, i] {
+				for (size_t j = i; j < kItems; j += n) {
+					for (;;) {
+						{
+							auto q = queue.lock();
+							if (q->size() < kCapacity) {
+								q->push_back(j);
+								break;
+							}
+						}
+						std::this_thread::yield();
+					}
+				}
+				producers.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		for (size_t i = 0; i < n; ++i) {
+			threads.emplace_back([&] {
+				uint64_t sum = 0;
+				for (;;) {
+					bool done = producers.load(std::memory_order_acquire) == 0;
+					{
+						auto q = queue.lock();
+						if (!q->empty()) {
+							sum += q->front();
+							q->pop_front();
+							continue;
+						}
+					}
+					if (done) {
+						break;
+					}
+					std::this_thread::yield();
+				}
+				benchmark::DoNotOptimize(sum);
+			});
+		}
+		for (auto &t : threads) {
+			t.join();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_MutexDeque)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,25 @@
+#include "rusty/sync.h"
+#include "rusty/sync/adaptive_mutex.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Increments a counter behind the lock, i.e., a critical section of a few
+// nanoseconds.
+template <typename M>
+void BM_MutexIncrement(benchmark::State &state) {
+	static M counter(0);
+	for (auto _ : state) {
+		++*counter.lock();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_MutexIncrement, rusty::sync::Mutex<uint64_t>)
+	->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexIncrement, rusty::sync::AdaptiveMutex<uint64_t>)
+	->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexIncrement, rusty::sync::ProfiledMutex<uint64_t>)
+	->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
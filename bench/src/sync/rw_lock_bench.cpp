@@ -0,0 +1,76 @@
+#include "rusty/sync.h"
+
+#include <benchmark/benchmark.h>
+#include <unordered_map>
+
+namespace {
+
+using Map = std::unordered_map<uint64_t, uint64_t>;
+
+constexpr uint64_t kKeys = 1 << 12;
+// One write every kWriteEvery operations.
+constexpr size_t kWriteEvery = 64;
+
+Map make_map() {
+	Map map;
+	for (uint64_t k = 0; k < kKeys; ++k) {
+		map[k] = k;
+	}
+	return map;
+}
+
+template <typename Read, typename Write>
+void run(benchmark::State &state, Read read, Write write) {
+	uint64_t key = state.thread_index() * 7919;
+	uint64_t sum = 0;
+	size_t ops = 0;
+	for (auto _ : state) {
+		key = (key * 6364136223846793005 + 1442695040888963407) % kKeys;
+		if (++ops % kWriteEvery == 0) {
+			write(key);
+		} else {
+			sum += read(key);
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MutexMap(benchmark::State &state) {
+	static rusty::sync::Mutex<Map> map(make_map());
+	run(
+		state,
+		[](uint64_t k) { return map.lock()->at(k); },
+		[](uint64_t k) { ++map.lock()->at(k); }
+	);
+}
+BENCHMARK(BM_MutexMap)->ThreadRange(1, 64)->UseRealTime();
+
+void BM_RwLockMap(benchmark::State &state) {
+	static rusty::sync::RwLock<Map> map(make_map());
+	run(
+		state,
+		[](uint64_t k) { return map.read()->at(k); },
+		[](uint64_t k) { ++map.write()->at(k); }
+	);
+}
+BENCHMARK(BM_RwLockMap)->ThreadRange(1, 64)->UseRealTime();
+
+void BM_ShardedRwLockMap(benchmark::State &state) {
+	static rusty::sync::ShardedRwLock<Map, 16> map;
+	static bool init = [] {
+		for (uint64_t k = 0; k < kKeys; ++k) {
+			(*map.write(k))[k] = k;
+		}
+		return true;
+	}();
+	(void)init;
+	run(
+		state,
+		[](uint64_t k) { return map.read(k)->at(k); },
+		[](uint64_t k) { ++map.write(k)->at(k); }
+	);
+}
+BENCHMARK(BM_ShardedRwLockMap)->ThreadRange(1, 64)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,34 @@
+#include "rusty/time.h"
+#include "rusty/time/fast_clock.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+template <typename I>
+void BM_Now(benchmark::State &state) {
+	// Excludes the one-time calibration and thread start.
+	(void)(I::now() - I::now());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(I::now());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Now, rusty::time::Instant);
+BENCHMARK_TEMPLATE(BM_Now, rusty::time::FastInstant);
+BENCHMARK_TEMPLATE(BM_Now, rusty::time::CoarseInstant);
+
+template <typename I>
+void BM_Elapsed(benchmark::State &state) {
+	auto start = I::now();
+	(void)start.elapsed();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(start.elapsed());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Elapsed, rusty::time::Instant);
+BENCHMARK_TEMPLATE(BM_Elapsed, rusty::time::FastInstant);
+BENCHMARK_TEMPLATE(BM_Elapsed, rusty::time::CoarseInstant);
+
+} // namespace
@@ -0,0 +1,36 @@
+#include "rusty/time/histogram.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+void BM_HistogramRecord(benchmark::State &state) {
+	static rusty::time::Histogram histogram;
+	uint64_t x = state.thread_index() + 1;
+	for (auto _ : state) {
+		x = x * 6364136223846793005 + 1442695040888963407;
+		histogram.record_nanos(x >> 44);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord)->ThreadRange(1, 16)->UseRealTime();
+
+// Includes the two Instant::now() of the timer.
+void BM_HistogramTimer(benchmark::State &state) {
+	rusty::time::Histogram histogram;
+	for (auto _ : state) {
+		auto timer = histogram.start_timer();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramTimer);
+
+void BM_HistogramSnapshot(benchmark::State &state) {
+	rusty::time::Histogram histogram;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(histogram.snapshot().p99());
+	}
+}
+BENCHMARK(BM_HistogramSnapshot);
+
+} // namespace
@@ -0,0 +1,199 @@
+#ifndef RUSTY_INDEXED_MIN_HEAP_H_
+#define RUSTY_INDEXED_MIN_HEAP_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/macro.h"
+#include "rusty/option.h"
+
+#include <cassert>
+#include <limits>
+#include <vector>
+
+namespace rusty {
+
+// A min-heap that hands out a handle for each pushed element, through which
+// the element can later be looked up, re-prioritized or removed in O(log n).
+// It shares the sift operations and the "Arity" parameter of MinHeap.
+template <typename T, typename Compare = std::less<T>, size_t Arity = 2>
+class IndexedMinHeap {
+	static_assert(Arity >= 2);
+
+public:
+	class Handle {
+	public:
+		bool operator==(const Handle &rhs) const {
+			return slot_ == rhs.slot_ && generation_ == rhs.generation_;
+		}
+		bool operator!=(const Handle &rhs) const {
+			return !(*this == rhs);
+		}
+
+	private:
+		Handle(size_t slot, size_t generation)
+		  : slot_(slot), generation_(generation) {}
+		size_t slot_;
+		// Slots are reused after their elements leave the heap. The generation
+		// tells stale handles apart from the handle of the new element.
+		size_t generation_;
+		friend class IndexedMinHeap;
+	};
+
+	explicit IndexedMinHeap(Compare compare = Compare())
+	  : cmp_(std::move(compare)) {}
+
+	bool is_empty() const {
+		return v_.empty();
+	}
+	size_t len() const {
+		return v_.size();
+	}
+	// Returns whether the element of "h" is still in the heap.
+	bool contains(Handle h) const {
+		return h.slot_ < slots_.size() &&
+			slots_[h.slot_].generation == h.generation_ &&
+			slots_[h.slot_].pos != kNotInHeap;
+	}
+
+	const T *peek() const {
+		if (v_.empty()) {
+			return nullptr;
+		}
+		return &v_[0].value;
+	}
+	Option<Handle> peek_handle() const {
+		if (v_.empty()) {
+			return None;
+		}
+		return handle_of(v_[0].slot);
+	}
+	// Returns nullptr if the element of "h" is no longer in the heap.
+	const T *get(Handle h) const {
+		if (!contains(h)) {
+			return nullptr;
+		}
+		return &v_[slots_[h.slot_].pos].value;
+	}
+
+	Handle push(T x) {
+		size_t slot;
+		if (free_slots_.empty()) {
+			slot = slots_.size();
+			slots_.push_back(Slot{kNotInHeap, 0});
+		} else {
+			slot = free_slots_.back();
+			free_slots_.pop_back();
+		}
+		v_.push_back(Node{std::move(x), slot});
+		sift_up(v_.size() - 1, std::move(v_.back()));
+		return handle_of(slot);
+	}
+
+	Option<T> pop() {
+		if (v_.empty()) {
+			return None;
+		}
+		return remove_at(0);
+	}
+	// Returns None if the element of "h" is no longer in the heap.
+	Option<T> remove(Handle h) {
+		if (!contains(h)) {
+			return None;
+		}
+		return remove_at(slots_[h.slot_].pos);
+	}
+
+	// Replaces the element of "h" with "x" and moves it to its new place.
+	void update(Handle h, T x) {
+		rusty_assert(contains(h), "Stale handle");
+		size_t pos = slots_[h.slot_].pos;
+		v_[pos].value = std::move(x);
+		fix(pos);
+	}
+	// Same as "update", but "x" must not be greater than the old element, so
+	// that it only needs to be sifted up.
+	void decrease_key(Handle h, T x) {
+		rusty_assert(contains(h), "Stale handle");
+		size_t pos = slots_[h.slot_].pos;
+		assert(!cmp_(v_[pos].value, x));
+		v_[pos].value = std::move(x);
+		sift_up(pos, std::move(v_[pos]));
+	}
+
+private:
+	static constexpr size_t kNotInHeap = std::numeric_limits<size_t>::max();
+
+	struct Node {
+		T value;
+		size_t slot;
+	};
+	struct Slot {
+		// The index of the element in v_.
+		size_t pos;
+		size_t generation;
+	};
+
+	Handle handle_of(size_t slot) const {
+		return Handle(slot, slots_[slot].generation);
+	}
+
+	// Compares the values of two nodes.
+	class NodeLess {
+	public:
+		bool operator()(const Node &a, const Node &b) {
+			return (*cmp)(a.value, b.value);
+		}
+		Compare *cmp;
+	};
+	// Every move into v_ goes through "Place" to keep slots_ up to date.
+	class Place {
+	public:
+		void operator()(size_t pos, Node &&node) {
+			heap->slots_[node.slot].pos = pos;
+			heap->v_[pos] = std::move(node);
+		}
+		IndexedMinHeap *heap;
+	};
+
+	void sift_up(size_t hole, Node x) {
+		detail::heap_sift_up<Arity>(v_.data(), hole, std::move(x),
+			NodeLess{&cmp_}, Place{this});
+	}
+	void sift_down(size_t hole, Node x) {
+		detail::heap_sift_down<Arity>(v_.data(), hole, std::move(x),
+			v_.size(), NodeLess{&cmp_}, Place{this});
+	}
+	// Moves v_[pos] to its place after its value changed.
+	void fix(size_t pos) {
+		if (pos > 0 &&
+				cmp_(v_[pos].value, v_[detail::heap_parent<Arity>(pos)].value)) {
+			sift_up(pos, std::move(v_[pos]));
+		} else {
+			sift_down(pos, std::move(v_[pos]));
+		}
+	}
+
+	T remove_at(size_t pos) {
+		Node removed = std::move(v_[pos]);
+		Slot &slot = slots_[removed.slot];
+		slot.pos = kNotInHeap;
+		++slot.generation;
+		free_slots_.push_back(removed.slot);
+
+		Node last = std::move(v_.back());
+		v_.pop_back();
+		if (pos < v_.size()) {
+			v_[pos] = std::move(last);
+			fix(pos);
+		}
+		return std::move(removed.value);
+	}
+
+	std::vector<Node> v_;
+	std::vector<Slot> slots_;
+	std::vector<size_t> free_slots_;
+	Compare cmp_;
+};
+
+} // namespace rusty
+
+#endif // RUSTY_INDEXED_MIN_HEAP_H_
@@ -4,13 +4,112 @@
 #include "rusty/macro.h"
 #include "rusty/option.h"
 
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
 #include <vector>
 
 namespace rusty {
 
-template <typename T, typename Compare = std::less<T>>
+namespace detail {
+
+// Sift operations shared by the heaps, on an implicit "Arity"-ary heap stored
+// in v[0..end). "less(a, b)" compares two elements. Every element is stored
+// with "place(pos, std::move(x))", so that a heap can track the positions of
+// its elements. Instead of swapping at every level, the element is moved out
+// once and the holes are filled by shifting the others.
+
+template <size_t Arity>
+size_t heap_parent(size_t i) {
+	return (i - 1) / Arity;
+}
+template <size_t Arity>
+size_t heap_first_child(size_t i) {
+	return i * Arity + 1;
+}
+
+// Returns the smallest one among the children starting at "first".
+template <size_t Arity, typename T, typename Less>
+size_t heap_min_child(const T *v, size_t first, size_t end, Less &&less) {
+	if constexpr (Arity == 2) {
+		// Branchless, since the outcome is unpredictable.
+		return first + (first + 1 < end && less(v[first + 1], v[first]));
+	}
+	size_t smallest = first;
+	if (first + Arity <= end) {
+		// All children exist. The trip count is a constant, so that the loop
+		// can be fully unrolled.
+		for (size_t i = 1; i < Arity; ++i) {
+			smallest = less(v[first + i], v[smallest]) ? first + i : smallest;
+		}
+	} else {
+		for (size_t child = first + 1; child < end; ++child) {
+			if (less(v[child], v[smallest])) {
+				smallest = child;
+			}
+		}
+	}
+	return smallest;
+}
+
+// Places "x", which was moved out of v[hole], at or above "hole".
+template <size_t Arity, typename T, typename Less, typename Place>
+void heap_sift_up(T *v, size_t hole, T x, Less &&less, Place &&place) {
+	while (hole > 0) {
+		size_t p = heap_parent<Arity>(hole);
+		if (!less(x, v[p])) {
+			break;
+		}
+		place(hole, std::move(v[p]));
+		hole = p;
+	}
+	place(hole, std::move(x));
+}
+
+// Places "x", which was moved out of v[hole], at or below "hole".
+template <size_t Arity, typename T, typename Less, typename Place>
+void heap_sift_down(
+	T *v, size_t hole, T x, size_t end, Less &&less, Place &&place
+) {
+	for (size_t child = heap_first_child<Arity>(hole); child < end;
+			child = heap_first_child<Arity>(hole)) {
+		child = heap_min_child<Arity>(v, child, end, less);
+		if (!less(v[child], x)) {
+			break;
+		}
+		place(hole, std::move(v[child]));
+		hole = child;
+	}
+	place(hole, std::move(x));
+}
+
+// Floyd's trick: the element that fills the hole comes from the bottom of the
+// heap, so it most likely belongs near the bottom again. Therefore, move the
+// hole all the way down to a leaf by promoting the smallest child without
+// comparing it against "x", and then sift "x" up from there. This takes about
+// half the comparisons of a normal sift-down.
+template <size_t Arity, typename T, typename Less, typename Place>
+void heap_sift_down_to_bottom(
+	T *v, size_t hole, T x, size_t end, Less &&less, Place &&place
+) {
+	for (size_t child = heap_first_child<Arity>(hole); child < end;
+			child = heap_first_child<Arity>(hole)) {
+		child = heap_min_child<Arity>(v, child, end, less);
+		place(hole, std::move(v[child]));
+		hole = child;
+	}
+	heap_sift_up<Arity>(v, hole, std::move(x), less, place);
+}
+
+} // namespace detail
+
+// "Arity" is the number of children of each node. A 4-ary or 8-ary heap is
+// shallower than a binary heap and keeps all children of a node in one or two
+// cache lines, which is usually faster for large heaps of small elements.
+template <typename T, typename Compare = std::less<T>, size_t Arity = 2>
 class MinHeap {
+	static_assert(Arity >= 2);
+
 public:
 	class PeekMut {
 	public:
@@ -26,13 +125,15 @@ public:
 			return *this;
 		}
 
-		~PeekMut() {
+		// Sifts the top down. If the comparator throws, the exception
+		// propagates, and the heap is left destructible but unordered.
+		~PeekMut() noexcept(false) {
 			if (heap_ == nullptr) {
 				return;
 			}
-			heap_->heapify_subtree(0);
 			rusty_assert(heap_->mut_borrowed_);
 			heap_->mut_borrowed_ = false;
+			heap_->sift_down(0);
 		}
 
 		T &operator*() {
@@ -51,19 +152,17 @@ public:
 		}
 
 	private:
-		PeekMut(MinHeap<T, Compare> &heap) : heap_(&heap) {
+		PeekMut(MinHeap &heap) : heap_(&heap) {
 			heap_->mut_borrowed_ = true;
 		}
-		MinHeap<T, Compare> *heap_;
+		MinHeap *heap_;
 		friend class MinHeap;
 	};
 
 	explicit MinHeap(
 		std::vector<T> v = {}, Compare compare = Compare()
 	) : v_(std::move(v)), cmp_(std::move(compare)) {
-		for (ssize_t i = v_.size() / 2 - 1; i >= 0; --i) {
-			heapify_subtree(i);
-		}
+		rebuild();
 	}
 	~MinHeap() {
 		rusty_assert(!mut_borrowed_);
@@ -83,6 +182,15 @@ public:
 		rusty_assert(!mut_borrowed_);
 		return v_.empty();
 	}
+	size_t len() const {
+		rusty_assert(!mut_borrowed_);
+		return v_.size();
+	}
+
+	// Reserves capacity for at least "additional" more elements.
+	void reserve(size_t additional) {
+		v_.reserve(v_.size() + additional);
+	}
 
 	const T *peek() const {
 		rusty_assert(!mut_borrowed_);
@@ -110,37 +218,133 @@ public:
 		return ret;
 	}
 
+	void push(T x) {
+		rusty_assert(!mut_borrowed_);
+		v_.push_back(std::move(x));
+		sift_up(v_.size() - 1, std::move(v_.back()));
+	}
+	template <typename... Args>
+	void emplace(Args &&...args) {
+		rusty_assert(!mut_borrowed_);
+		v_.emplace_back(std::forward<Args>(args)...);
+		sift_up(v_.size() - 1, std::move(v_.back()));
+	}
+
+	// Pushes all elements of "range". The elements are moved if "range" is an
+	// rvalue. Depending on the number of new elements, they are either sifted
+	// up one by one, or the whole heap is rebuilt in O(n).
+	template <typename Range>
+	void extend(Range &&range) {
+		rusty_assert(!mut_borrowed_);
+		size_t start = v_.size();
+		for (auto &x : range) {
+			if constexpr (std::is_rvalue_reference_v<Range &&>) {
+				v_.push_back(std::move(x));
+			} else {
+				v_.push_back(x);
+			}
+		}
+		rebuild_tail(start);
+	}
+
+	// Returns the underlying vector in arbitrary order.
+	std::vector<T> into_vec() && {
+		rusty_assert(!mut_borrowed_);
+		return std::move(v_);
+	}
+	// Returns the elements in ascending order. Sorts in place.
+	std::vector<T> into_sorted_vec() && {
+		rusty_assert(!mut_borrowed_);
+		for (size_t end = v_.size(); end > 1; --end) {
+			// Move the minimum to the end.
+			T x = std::move(v_[end - 1]);
+			v_[end - 1] = std::move(v_[0]);
+			sift_down_to_bottom(0, std::move(x), end - 1);
+		}
+		std::reverse(v_.begin(), v_.end());
+		return std::move(v_);
+	}
+
 private:
-	void heapify_subtree(size_t i) {
-		assert(i < v_.size());
-		size_t smallest = i;
-		size_t left = (i << 1) + 1;
-		if (left < v_.size() && cmp_(v_[left], v_[smallest])) {
-			smallest = left;
-		}
-		size_t right = (i << 1) + 2;
-		if (right < v_.size() && cmp_(v_[right], v_[smallest])) {
-			smallest = right;
-		}
-		if (smallest == i) {
+	static size_t parent(size_t i) {
+		return detail::heap_parent<Arity>(i);
+	}
+	// Moves "x" into v_[pos]. MinHeap does not track positions.
+	struct Place {
+		void operator()(size_t pos, T &&x) {
+			v[pos] = std::move(x);
+		}
+		T *v;
+	};
+
+	// Sifts the element at "hole" down to its place.
+	void sift_down(size_t hole) {
+		size_t end = v_.size();
+		assert(hole < end);
+		if (detail::heap_first_child<Arity>(hole) >= end) {
 			return;
 		}
-		std::swap(v_[i], v_[smallest]);
-		heapify_subtree(smallest);
+		T x = std::move(v_[hole]);
+		detail::heap_sift_down<Arity>(
+			v_.data(), hole, std::move(x), end, cmp_, Place{v_.data()});
+	}
+	void sift_up(size_t hole, T x) {
+		detail::heap_sift_up<Arity>(
+			v_.data(), hole, std::move(x), cmp_, Place{v_.data()});
 	}
-	void heapify_root_if_exists() {
+	// Only v_[0..end) is considered as the heap.
+	void sift_down_to_bottom(size_t hole, T x, size_t end) {
+		detail::heap_sift_down_to_bottom<Arity>(
+			v_.data(), hole, std::move(x), end, cmp_, Place{v_.data()});
+	}
+
+	// The root must have been moved out.
+	void remove_root() {
+		T last = std::move(v_.back());
+		v_.pop_back();
 		if (v_.empty()) {
 			return;
 		}
-		heapify_subtree(0);
+		sift_down_to_bottom(0, std::move(last), v_.size());
 	}
 
-	void remove_root() {
-		if (v_.size() > 1) {
-			v_[0] = std::move(v_.back());
+	void rebuild() {
+		if (v_.size() <= 1) {
+			return;
+		}
+		for (ssize_t i = parent(v_.size() - 1); i >= 0; --i) {
+			sift_down(i);
+		}
+	}
+	// Restores the heap property after appending v_[start..).
+	void rebuild_tail(size_t start) {
+		size_t len = v_.size();
+		size_t tail_len = len - start;
+		if (tail_len == 0) {
+			return;
+		}
+		// Sifting up each new element costs O(tail_len * log(start)) in the
+		// worst case, while rebuilding costs O(len) with about 2 * len
+		// comparisons. The heuristic is borrowed from Rust's BinaryHeap.
+		bool better_to_rebuild;
+		if (start < tail_len) {
+			better_to_rebuild = true;
+		} else if (len <= 2048) {
+			size_t log2_start = 0;
+			while ((start >> log2_start) > 1) {
+				++log2_start;
+			}
+			better_to_rebuild = 2 * len < tail_len * log2_start;
+		} else {
+			better_to_rebuild = 2 * len < tail_len * 11;
+		}
+		if (better_to_rebuild) {
+			rebuild();
+		} else {
+			for (size_t i = start; i < len; ++i) {
+				sift_up(i, std::move(v_[i]));
+			}
 		}
-		v_.pop_back();
-		heapify_root_if_exists();
 	}
 
 	std::vector<T> v_;
@@ -153,6 +357,14 @@ MinHeap<T, Compare> MakeMinHeap(std::vector<T> v, Compare compare = Compare()) {
 	return MinHeap<T, Compare>(std::move(v), std::move(compare));
 }
 
+// Usage: MakeMinHeap<4>(v, compare)
+template <size_t Arity, typename T, typename Compare = std::less<T>>
+MinHeap<T, Compare, Arity> MakeMinHeap(
+	std::vector<T> v, Compare compare = Compare()
+) {
+	return MinHeap<T, Compare, Arity>(std::move(v), std::move(compare));
+}
+
 }  // namespace rusty
 
 #endif // RUSTY_MIN_HEAP_H_
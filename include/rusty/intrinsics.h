@@ -1,23 +1,164 @@
 #ifndef RUSTY_INTRINSICS_H_
 #define RUSTY_INTRINSICS_H_
- 
+
+#include "rusty/option.h"
+#include "rusty/primitive.h"
+
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
 
 namespace rusty {
 namespace intrinsics {
 
-// Returns the previous value
+// Hints the CPU that the caller is busy-waiting.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Stores "f(previous)" if it returns Some, retrying if "dst" was changed
+// concurrently. "set_order" is the order of the successful update, and
+// "fetch_order" is the order of the loads.
+//
+// Returns the previous value if updated, otherwise None.
+template <typename T, typename F>
+Option<T> fetch_update(
+	std::atomic<T> &dst,
+	std::memory_order set_order,
+	std::memory_order fetch_order,
+	F f
+) {
+	T x = dst.load(fetch_order);
+	for (;;) {
+		Option<T> next = f(x);
+		if (next.is_none()) {
+			return None;
+		}
+		if (dst.compare_exchange_weak(
+				x, std::move(next).unwrap_unchecked(), set_order, fetch_order)) {
+			return x;
+		}
+	}
+}
+
+// Stores "src" if it is greater. "order" only applies if "dst" is updated,
+// otherwise this is a relaxed load, so that readers of a high-water mark do
+// not write to the cache line.
+//
+// Returns the previous value.
 template <typename T>
-T atomic_max_relaxed(std::atomic<T> &dst, T src) {
+T atomic_max(
+	std::atomic<T> &dst, T src, std::memory_order order = std::memory_order_seq_cst
+) {
 	T x = dst.load(std::memory_order_relaxed);
 	while (src > x) {
-		T expected = x;
-		if (dst.compare_exchange_weak(expected, src))
+		if (dst.compare_exchange_weak(x, src, order, std::memory_order_relaxed))
 			break;
-		x = dst.load(std::memory_order_relaxed);
 	}
 	return x;
 }
+// Stores "src" if it is less. Returns the previous value.
+template <typename T>
+T atomic_min(
+	std::atomic<T> &dst, T src, std::memory_order order = std::memory_order_seq_cst
+) {
+	T x = dst.load(std::memory_order_relaxed);
+	while (src < x) {
+		if (dst.compare_exchange_weak(x, src, order, std::memory_order_relaxed))
+			break;
+	}
+	return x;
+}
+
+// Returns the previous value
+template <typename T>
+T atomic_max_relaxed(std::atomic<T> &dst, T src) {
+	return atomic_max(dst, src, std::memory_order_relaxed);
+}
+template <typename T>
+T atomic_min_relaxed(std::atomic<T> &dst, T src) {
+	return atomic_min(dst, src, std::memory_order_relaxed);
+}
+
+// Modern x86 CPUs prefetch cache lines in pairs, and some ARM CPUs have 128
+// byte cache lines.
+#if defined(__x86_64__) || defined(__aarch64__) || defined(__powerpc64__)
+constexpr size_t kCacheLineSize = 128;
+#else
+constexpr size_t kCacheLineSize = 64;
+#endif
+
+// Puts "T" on its own cache line(s), so that writes to it do not slow down
+// accesses to its neighbors (false sharing).
+template <typename T>
+class alignas(kCacheLineSize) CachePadded {
+public:
+	template <
+		typename... Args,
+		typename = std::enable_if_t<std::is_constructible_v<T, Args...>>
+	>
+	CachePadded(Args &&...args) : v_(std::forward<Args>(args)...) {}
+
+	T &operator*() { return v_; }
+	const T &operator*() const { return v_; }
+	T *operator->() { return &v_; }
+	const T *operator->() const { return &v_; }
+
+private:
+	T v_;
+};
+
+namespace detail {
+
+// Threads get consecutive ids on first use, so that concurrently running
+// threads are spread over different shards.
+inline size_t thread_shard_id() {
+	static std::atomic<size_t> next{0};
+	thread_local size_t id = next.fetch_add(1, std::memory_order_relaxed);
+	return id;
+}
+
+} // namespace detail
+
+// A counter for frequent updates from many threads. Each thread adds to its own
+// cache-padded shard, and reads sum up all shards. Decrements work by
+// adding the two's complement.
+class ShardedCounter {
+public:
+	explicit ShardedCounter(
+		size_t shards = std::thread::hardware_concurrency()
+	) : mask_(next_power_of_two(std::max<size_t>(shards, 1)) - 1),
+		shards_(new CachePadded<std::atomic<uint64_t>>[mask_ + 1]) {
+		for (size_t i = 0; i <= mask_; ++i) {
+			shards_[i]->store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void add(uint64_t x) {
+		shards_[detail::thread_shard_id() & mask_]->fetch_add(
+			x, std::memory_order_relaxed
+		);
+	}
+	// Not a snapshot: adds that happen concurrently may or may not be counted.
+	uint64_t sum() const {
+		uint64_t sum = 0;
+		for (size_t i = 0; i <= mask_; ++i) {
+			sum += shards_[i]->load(std::memory_order_relaxed);
+		}
+		return sum;
+	}
+
+private:
+	const size_t mask_;
+	std::unique_ptr<CachePadded<std::atomic<uint64_t>>[]> shards_;
+};
 
 } // namespace intrinsics
 } // namespace rusty
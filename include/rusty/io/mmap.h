@@ -0,0 +1,151 @@
+#ifndef RUSTY_IO_MMAP_H_
+#define RUSTY_IO_MMAP_H_
+
+#include "rusty/error.h"
+#include "rusty/iter/iterator.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace rusty {
+namespace io {
+
+// impl TraitIterator
+//
+// Yields the frames of a byte range as views into it without copying. A frame
+// is a native-endian uint32_t length followed by the bytes, the format of the
+// spill files of ExternalSorter. Iteration stops at a truncated frame, which
+// is left in "remainder".
+class Frames {
+public:
+	using value_type = std::string_view;
+
+	Frames(const char *start, const char *end) : it_(start), end_(end) {}
+
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		uint32_t len;
+		if (static_cast<size_t>(end_ - it_) < sizeof(len)) {
+			return None;
+		}
+		memcpy(&len, it_, sizeof(len));
+		if (static_cast<size_t>(end_ - it_) - sizeof(len) < len) {
+			return None;
+		}
+		std::string_view frame(it_ + sizeof(len), len);
+		it_ += sizeof(len) + len;
+		return frame;
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+	// The bytes that are not yielded yet, which are not empty after the end of
+	// the iteration only if the last frame is truncated.
+	std::string_view remainder() const {
+		return std::string_view(it_, end_ - it_);
+	}
+
+private:
+	const char *it_;
+	const char *end_;
+};
+
+// A read-only memory-mapped file. The records or frames yielded by its
+// iterators point into the mapping, so it must outlive them.
+class Mmap {
+public:
+	Mmap(const Mmap &) = delete;
+	Mmap &operator=(const Mmap &) = delete;
+	Mmap(Mmap &&rhs) : data_(rhs.data_), len_(rhs.len_) {
+		rhs.data_ = nullptr;
+		rhs.len_ = 0;
+	}
+	Mmap &operator=(Mmap &&rhs) {
+		std::swap(data_, rhs.data_);
+		std::swap(len_, rhs.len_);
+		return *this;
+	}
+	~Mmap() {
+		if (len_ != 0) {
+			munmap(data_, len_);
+		}
+	}
+
+	// Maps the whole file, and advises the kernel that it will be read
+	// sequentially, so that it reads ahead aggressively.
+	static Result<Mmap> open(const std::string &path) {
+		int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) {
+			return Error::from_raw_os_error(errno);
+		}
+		struct stat st;
+		if (fstat(fd, &st) == -1) {
+			int err = errno;
+			close(fd);
+			return Error::from_raw_os_error(err);
+		}
+		size_t len = st.st_size;
+		if (len == 0) {
+			// mmap rejects empty mappings.
+			close(fd);
+			return Mmap(nullptr, 0);
+		}
+		void *data = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+		int err = errno;
+		// The mapping stays valid after the descriptor is closed.
+		close(fd);
+		if (data == MAP_FAILED) {
+			return Error::from_raw_os_error(err);
+		}
+		// Only a hint, so failures are ignored.
+		madvise(data, len, MADV_SEQUENTIAL);
+		return Mmap(static_cast<char *>(data), len);
+	}
+
+	const char *data() const {
+		return data_;
+	}
+	size_t len() const {
+		return len_;
+	}
+
+	// The file as an array of "T", e.g., a sorted run of fixed-size keys,
+	// which can be fed to MergingIterator with MakePeekable. The length of the
+	// file must be a multiple of sizeof(T).
+	template <typename T>
+	slice::Iter<T> records() const {
+		static_assert(std::is_trivially_copyable_v<T>);
+		// Not inlined into the condition, which rusty_assert pastes into the
+		// format string.
+		size_t rem = len_ % sizeof(T);
+		rusty_assert(rem == 0,
+			"The file length %zu is not a multiple of %zu", len_, sizeof(T));
+		// mmap returns page-aligned addresses.
+		const T *start = reinterpret_cast<const T *>(data_);
+		return slice::Iter<T>(start, start + len_ / sizeof(T));
+	}
+
+	// The file as length-prefixed frames.
+	Frames frames() const {
+		return Frames(data_, data_ + len_);
+	}
+
+private:
+	Mmap(char *data, size_t len) : data_(data), len_(len) {}
+
+	char *data_;
+	size_t len_;
+};
+
+} // namespace io
+} // namespace rusty
+
+#endif // RUSTY_IO_MMAP_H_
@@ -0,0 +1,544 @@
+#ifndef RUSTY_ADAPTERS_H_
+#define RUSTY_ADAPTERS_H_
+
+#include "rusty/iter/iterator.h"
+
+#include <type_traits>
+#include <utility>
+
+// Statically dispatched iterator adapters. They wrap any type with
+// "next(type_tag_t<Iterator<value_type>>)", so that a chain of them is
+// inlined into a single loop. A std::unique_ptr to a trait object is
+// accepted too, at the cost of a virtual call per item of that source.
+//
+// Like the other factories, MakeX takes ownership of the wrapped iterator.
+//
+// Map, Take, Skip, Zip and Enumerate have "next_unchecked" if the iterators
+// they wrap have it, e.g., slice iterators. Since their size hints are exact
+// then, fold and for_each check the length once and run the chain without
+// per-item end checks.
+
+namespace rusty {
+
+namespace detail {
+
+template <typename I>
+using IntoIter = std::conditional_t<IteratorImpl<I>::impl, IteratorImpl<I>, I>;
+
+template <typename T>
+class OptionValue;
+template <typename T>
+class OptionValue<Option<T>> {
+public:
+	using type = T;
+};
+
+template <typename I>
+Option<typename I::value_type> next(I &iter) {
+	return iter.next(type_tag_t<Iterator<typename I::value_type>>());
+}
+
+} // namespace detail
+
+template <typename I, typename F>
+class Map {
+public:
+	using value_type = std::decay_t<
+		std::invoke_result_t<F &, typename I::value_type>
+	>;
+	Map(I &&iter, F f) : iter_(std::move(iter)), f_(std::move(f)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		auto x = detail::next(iter_);
+		if (x.is_none()) {
+			return None;
+		}
+		return f_(std::move(x).unwrap_unchecked());
+	}
+	template <
+		typename J = I, typename = decltype(std::declval<J &>().next_unchecked())
+	>
+	value_type next_unchecked() {
+		return f_(iter_.next_unchecked());
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return detail::size_hint(iter_);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	F f_;
+};
+
+template <typename I, typename F>
+Map<detail::IntoIter<I>, F> MakeMap(I &&iter, F f) {
+	return Map<detail::IntoIter<I>, F>(
+		detail::IntoIter<I>(std::forward<I>(iter)), std::move(f)
+	);
+}
+
+// Yields the items for which "pred(const value_type &)" returns true.
+template <typename I, typename P>
+class Filter {
+public:
+	using value_type = typename I::value_type;
+	Filter(I &&iter, P pred) : iter_(std::move(iter)), pred_(std::move(pred)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		for (;;) {
+			auto x = detail::next(iter_);
+			if (x.is_none() || pred_(*x.as_ptr())) {
+				return x;
+			}
+		}
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return SizeHint(0, detail::size_hint(iter_).second);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	P pred_;
+};
+
+template <typename I, typename P>
+Filter<detail::IntoIter<I>, P> MakeFilter(I &&iter, P pred) {
+	return Filter<detail::IntoIter<I>, P>(
+		detail::IntoIter<I>(std::forward<I>(iter)), std::move(pred)
+	);
+}
+
+// "f" returns an Option, and the None results are skipped.
+template <typename I, typename F>
+class FilterMap {
+public:
+	using value_type = typename detail::OptionValue<
+		std::invoke_result_t<F &, typename I::value_type>
+	>::type;
+	FilterMap(I &&iter, F f) : iter_(std::move(iter)), f_(std::move(f)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		for (;;) {
+			auto x = detail::next(iter_);
+			if (x.is_none()) {
+				return None;
+			}
+			Option<value_type> ret = f_(std::move(x).unwrap_unchecked());
+			if (ret.is_some()) {
+				return ret;
+			}
+		}
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return SizeHint(0, detail::size_hint(iter_).second);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	F f_;
+};
+
+template <typename I, typename F>
+FilterMap<detail::IntoIter<I>, F> MakeFilterMap(I &&iter, F f) {
+	return FilterMap<detail::IntoIter<I>, F>(
+		detail::IntoIter<I>(std::forward<I>(iter)), std::move(f)
+	);
+}
+
+template <typename I>
+class Take {
+public:
+	using value_type = typename I::value_type;
+	Take(I &&iter, size_t n) : iter_(std::move(iter)), n_(n) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (n_ == 0) {
+			return None;
+		}
+		--n_;
+		return detail::next(iter_);
+	}
+	template <
+		typename J = I, typename = decltype(std::declval<J &>().next_unchecked())
+	>
+	value_type next_unchecked() {
+		--n_;
+		return iter_.next_unchecked();
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		size_t taken = detail::next_batch(iter_, out, std::min(n, n_));
+		n_ -= taken;
+		return taken;
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		auto [lower, upper] = detail::size_hint(iter_);
+		if (upper.is_some()) {
+			return SizeHint(
+				std::min(lower, n_), std::min(*upper.as_ptr(), n_)
+			);
+		}
+		return SizeHint(std::min(lower, n_), n_);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	size_t n_;
+};
+
+template <typename I>
+Take<detail::IntoIter<I>> MakeTake(I &&iter, size_t n) {
+	return Take<detail::IntoIter<I>>(
+		detail::IntoIter<I>(std::forward<I>(iter)), n
+	);
+}
+
+// The first "n" items are skipped at the first call.
+template <typename I>
+class Skip {
+public:
+	using value_type = typename I::value_type;
+	Skip(I &&iter, size_t n) : iter_(std::move(iter)), n_(n) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		skip();
+		return detail::next(iter_);
+	}
+	template <
+		typename J = I, typename = decltype(std::declval<J &>().next_unchecked())
+	>
+	value_type next_unchecked() {
+		skip();
+		return iter_.next_unchecked();
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		skip();
+		return detail::next_batch(iter_, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		auto [lower, upper] = detail::size_hint(iter_);
+		lower = lower > n_ ? lower - n_ : 0;
+		if (upper.is_some()) {
+			size_t u = *upper.as_ptr();
+			return SizeHint(lower, u > n_ ? u - n_ : 0);
+		}
+		return SizeHint(lower, None);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	void skip() {
+		for (; n_ != 0; --n_) {
+			if (detail::next(iter_).is_none()) {
+				n_ = 0;
+				break;
+			}
+		}
+	}
+
+	I iter_;
+	size_t n_;
+};
+
+template <typename I>
+Skip<detail::IntoIter<I>> MakeSkip(I &&iter, size_t n) {
+	return Skip<detail::IntoIter<I>>(
+		detail::IntoIter<I>(std::forward<I>(iter)), n
+	);
+}
+
+// Yields the items of "a", then the items of "b".
+template <typename A, typename B>
+class Chain {
+public:
+	using value_type = typename A::value_type;
+	static_assert(std::is_same_v<value_type, typename B::value_type>);
+	Chain(A &&a, B &&b) : a_(std::move(a)), b_(std::move(b)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (!a_done_) {
+			auto x = detail::next(a_);
+			if (x.is_some()) {
+				return x;
+			}
+			a_done_ = true;
+		}
+		return detail::next(b_);
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		size_t taken = 0;
+		if (!a_done_) {
+			taken = detail::next_batch(a_, out, n);
+			if (taken == n) {
+				return taken;
+			}
+			a_done_ = true;
+		}
+		return taken + detail::next_batch(b_, out, n - taken);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		if (a_done_) {
+			return detail::size_hint(b_);
+		}
+		return detail::size_hint_add(
+			detail::size_hint(a_), detail::size_hint(b_)
+		);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	A a_;
+	B b_;
+	bool a_done_ = false;
+};
+
+template <typename A, typename B>
+Chain<detail::IntoIter<A>, detail::IntoIter<B>> MakeChain(A &&a, B &&b) {
+	return Chain<detail::IntoIter<A>, detail::IntoIter<B>>(
+		detail::IntoIter<A>(std::forward<A>(a)),
+		detail::IntoIter<B>(std::forward<B>(b))
+	);
+}
+
+// Yields pairs of items until either iterator is exhausted.
+template <typename A, typename B>
+class Zip {
+public:
+	using value_type = std::pair<typename A::value_type, typename B::value_type>;
+	Zip(A &&a, B &&b) : a_(std::move(a)), b_(std::move(b)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		auto x = detail::next(a_);
+		if (x.is_none()) {
+			return None;
+		}
+		auto y = detail::next(b_);
+		if (y.is_none()) {
+			return None;
+		}
+		return value_type(
+			std::move(x).unwrap_unchecked(), std::move(y).unwrap_unchecked()
+		);
+	}
+	template <
+		typename A1 = A,
+		typename B1 = B,
+		typename = decltype(std::declval<A1 &>().next_unchecked()),
+		typename = decltype(std::declval<B1 &>().next_unchecked())
+	>
+	value_type next_unchecked() {
+		auto x = a_.next_unchecked();
+		return value_type(std::move(x), b_.next_unchecked());
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		auto [a_lower, a_upper] = detail::size_hint(a_);
+		auto [b_lower, b_upper] = detail::size_hint(b_);
+		Option<size_t> upper = a_upper.is_none() ? b_upper :
+			b_upper.is_none() ? a_upper :
+			Option<size_t>(std::min(*a_upper.as_ptr(), *b_upper.as_ptr()));
+		return SizeHint(std::min(a_lower, b_lower), upper);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	A a_;
+	B b_;
+};
+
+template <typename A, typename B>
+Zip<detail::IntoIter<A>, detail::IntoIter<B>> MakeZip(A &&a, B &&b) {
+	return Zip<detail::IntoIter<A>, detail::IntoIter<B>>(
+		detail::IntoIter<A>(std::forward<A>(a)),
+		detail::IntoIter<B>(std::forward<B>(b))
+	);
+}
+
+// Yields pairs of the index and the item.
+template <typename I>
+class Enumerate {
+public:
+	using value_type = std::pair<size_t, typename I::value_type>;
+	explicit Enumerate(I &&iter) : iter_(std::move(iter)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		auto x = detail::next(iter_);
+		if (x.is_none()) {
+			return None;
+		}
+		return value_type(i_++, std::move(x).unwrap_unchecked());
+	}
+	template <
+		typename J = I, typename = decltype(std::declval<J &>().next_unchecked())
+	>
+	value_type next_unchecked() {
+		return value_type(i_++, iter_.next_unchecked());
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return detail::size_hint(iter_);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	size_t i_ = 0;
+};
+
+template <typename I>
+Enumerate<detail::IntoIter<I>> MakeEnumerate(I &&iter) {
+	return Enumerate<detail::IntoIter<I>>(
+		detail::IntoIter<I>(std::forward<I>(iter))
+	);
+}
+
+// Yields items while "pred(const value_type &)" returns true. The first item
+// for which it returns false is consumed and dropped.
+template <typename I, typename P>
+class TakeWhile {
+public:
+	using value_type = typename I::value_type;
+	TakeWhile(I &&iter, P pred)
+	  : iter_(std::move(iter)), pred_(std::move(pred)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (done_) {
+			return None;
+		}
+		auto x = detail::next(iter_);
+		if (x.is_none() || !pred_(*x.as_ptr())) {
+			done_ = true;
+			return None;
+		}
+		return x;
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		if (done_) {
+			return SizeHint(0, 0);
+		}
+		return SizeHint(0, detail::size_hint(iter_).second);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	I iter_;
+	P pred_;
+	bool done_ = false;
+};
+
+template <typename I, typename P>
+TakeWhile<detail::IntoIter<I>, P> MakeTakeWhile(I &&iter, P pred) {
+	return TakeWhile<detail::IntoIter<I>, P>(
+		detail::IntoIter<I>(std::forward<I>(iter)), std::move(pred)
+	);
+}
+
+// Yields the items of a double-ended iterator in reverse order, e.g., a
+// descending scan of a sorted slice.
+template <typename I>
+class Rev {
+public:
+	using value_type = typename I::value_type;
+	explicit Rev(I &&iter) : iter_(std::move(iter)) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		return iter_.next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		return detail::next_batch_by_next(*this, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return detail::size_hint(iter_);
+	}
+	Option<value_type> next_back(type_tag_t<DoubleEndedIterator<value_type>>) {
+		return detail::next(iter_);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+	Option<value_type> next_back() {
+		return next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+	}
+
+private:
+	I iter_;
+};
+
+template <typename I>
+Rev<detail::IntoIter<I>> MakeRev(I &&iter) {
+	return Rev<detail::IntoIter<I>>(
+		detail::IntoIter<I>(std::forward<I>(iter))
+	);
+}
+
+// Returns f(...f(f(init, x0), x1)..., xn).
+template <typename I, typename B, typename F>
+B fold(I &&iter, B init, F f) {
+	detail::IntoIter<I> it(std::forward<I>(iter));
+	if constexpr (detail::HasNextUnchecked<detail::IntoIter<I>>::value) {
+		auto len = detail::exact_len(it);
+		if (len.is_some()) {
+			for (size_t n = *len.as_ptr(); n != 0; --n) {
+				init = f(std::move(init), it.next_unchecked());
+			}
+			return init;
+		}
+	}
+	for (;;) {
+		auto x = detail::next(it);
+		if (x.is_none()) {
+			return init;
+		}
+		init = f(std::move(init), std::move(x).unwrap_unchecked());
+	}
+}
+
+template <typename I, typename F>
+void for_each(I &&iter, F f) {
+	detail::IntoIter<I> it(std::forward<I>(iter));
+	if constexpr (detail::HasNextUnchecked<detail::IntoIter<I>>::value) {
+		auto len = detail::exact_len(it);
+		if (len.is_some()) {
+			for (size_t n = *len.as_ptr(); n != 0; --n) {
+				f(it.next_unchecked());
+			}
+			return;
+		}
+	}
+	for (;;) {
+		auto x = detail::next(it);
+		if (x.is_none()) {
+			return;
+		}
+		f(std::move(x).unwrap_unchecked());
+	}
+}
+
+} // namespace rusty
+
+#endif // RUSTY_ADAPTERS_H_
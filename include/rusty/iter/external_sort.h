@@ -0,0 +1,439 @@
+#ifndef RUSTY_EXTERNAL_SORT_H_
+#define RUSTY_EXTERNAL_SORT_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/error.h"
+#include "rusty/iter/merging_iterator.h"
+#include "rusty/iter/peekable.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <variant>
+
+namespace rusty {
+
+// Serializer of ExternalSorter for trivially copyable "T".
+template <typename T>
+class PodSerde {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+	void serialize(const T &x, std::string &out) const {
+		out.append(reinterpret_cast<const char *>(&x), sizeof(x));
+	}
+	T deserialize(const char *data, size_t len) const {
+		rusty_assert(len == sizeof(T));
+		T x;
+		memcpy(&x, data, sizeof(T));
+		return x;
+	}
+};
+
+// Serializer of ExternalSorter for std::string.
+class StringSerde {
+public:
+	void serialize(const std::string &x, std::string &out) const {
+		out.append(x);
+	}
+	std::string deserialize(const char *data, size_t len) const {
+		return std::string(data, len);
+	}
+};
+
+namespace detail {
+
+inline io::Error last_os_error() {
+	return io::Error::from_raw_os_error(errno == 0 ? EIO : errno);
+}
+
+// An anonymous temporary file: it is unlinked right after creation, so that
+// it is removed when closed, even if the process crashes.
+//
+// The stream has its own buffer of kBufSize bytes while it is written, and
+// again once it is read. In between, i.e., while the run waits to be merged,
+// it holds no buffer.
+class SpillFile {
+public:
+	static constexpr size_t kBufSize = 1 << 20;
+
+	SpillFile(const SpillFile &) = delete;
+	SpillFile &operator=(const SpillFile &) = delete;
+	SpillFile(SpillFile &&rhs)
+	  : f_(rhs.f_), buf_(std::move(rhs.buf_)), len_(rhs.len_) {
+		rhs.f_ = nullptr;
+	}
+	SpillFile &operator=(SpillFile &&rhs) {
+		std::swap(f_, rhs.f_);
+		std::swap(buf_, rhs.buf_);
+		std::swap(len_, rhs.len_);
+		return *this;
+	}
+	~SpillFile() {
+		if (f_ != nullptr) {
+			fclose(f_);
+		}
+	}
+
+	static io::Result<SpillFile> create(const std::string &dir) {
+		std::string path = dir + "/rusty-sort-XXXXXX";
+		int fd = mkstemp(path.data());
+		if (fd == -1) {
+			return last_os_error();
+		}
+		unlink(path.c_str());
+		FILE *f = fdopen(fd, "wb");
+		if (f == nullptr) {
+			auto err = last_os_error();
+			close(fd);
+			return err;
+		}
+		SpillFile file(f);
+		file.set_buf();
+		return file;
+	}
+
+	// Frames are a native-endian uint32_t length followed by the bytes.
+	io::Result<std::monostate> write(const std::string &frame) {
+		rusty_assert(frame.size() <= UINT32_MAX);
+		uint32_t len = frame.size();
+		if (fwrite(&len, sizeof(len), 1, f_) != 1 ||
+				fwrite(frame.data(), 1, len, f_) != len) {
+			return last_os_error();
+		}
+		++len_;
+		return std::monostate();
+	}
+	// Flushes the written frames, releases the buffer, and reopens the file
+	// for reading from the start. The file stays alive through a duplicated
+	// descriptor, since it is already unlinked.
+	io::Result<std::monostate> finish_write() {
+		int fd = dup(fileno(f_));
+		if (fd == -1) {
+			return last_os_error();
+		}
+		int ret = fclose(f_);
+		f_ = nullptr;
+		buf_.reset();
+		if (ret != 0 || lseek(fd, 0, SEEK_SET) == -1) {
+			auto err = last_os_error();
+			close(fd);
+			return err;
+		}
+		f_ = fdopen(fd, "rb");
+		if (f_ == nullptr) {
+			auto err = last_os_error();
+			close(fd);
+			return err;
+		}
+		return std::monostate();
+	}
+	// Returns false at the end of the file.
+	bool read(std::string &frame) {
+		if (buf_ == nullptr) {
+			set_buf();
+		}
+		uint32_t len;
+		if (fread(&len, sizeof(len), 1, f_) != 1) {
+			rusty_assert(!ferror(f_), "Fail to read spill file: %s",
+				strerror(errno));
+			return false;
+		}
+		frame.resize(len);
+		if (fread(frame.data(), 1, len, f_) != len) {
+			rusty_panic("Truncated spill file: %s",
+				ferror(f_) ? strerror(errno) : "unexpected EOF");
+		}
+		return true;
+	}
+	// The number of written frames.
+	size_t len() const {
+		return len_;
+	}
+
+private:
+	explicit SpillFile(FILE *f) : f_(f), len_(0) {}
+
+	// Must be called before any I/O on the stream. glibc ignores the size if
+	// the buffer is null, so the buffer is allocated here.
+	void set_buf() {
+		buf_.reset(new char[kBufSize]);
+		setvbuf(f_, buf_.get(), _IOFBF, kBufSize);
+	}
+
+	FILE *f_;
+	// Outlives f_, which is closed in the destructor.
+	std::unique_ptr<char[]> buf_;
+	size_t len_;
+};
+
+// impl TraitIterator
+//
+// Reads back a sorted run. Since iterators can't return errors, it panics if
+// the spill file can't be read, which only happens on hardware or filesystem
+// failures after it has been written successfully.
+template <typename T, typename Serde>
+class SpillReader {
+public:
+	using value_type = T;
+
+	SpillReader(SpillFile file, Serde serde)
+	  : file_(std::move(file)), serde_(std::move(serde)),
+		remaining_(file_.len()) {}
+
+	Option<T> next(type_tag_t<Iterator<T>>) {
+		if (!file_.read(frame_)) {
+			return None;
+		}
+		--remaining_;
+		return serde_.deserialize(frame_.data(), frame_.size());
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const {
+		return SizeHint(remaining_, remaining_);
+	}
+
+private:
+	SpillFile file_;
+	Serde serde_;
+	size_t remaining_;
+	std::string frame_;
+};
+
+// impl TraitIterator
+//
+// Moves the items out of a vector.
+template <typename T>
+class VecIntoIter {
+public:
+	using value_type = T;
+
+	explicit VecIntoIter(std::vector<T> v) : v_(std::move(v)), i_(0) {}
+
+	Option<T> next(type_tag_t<Iterator<T>>) {
+		if (i_ == v_.size()) {
+			return None;
+		}
+		return std::move(v_[i_++]);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const {
+		return SizeHint(v_.size() - i_, v_.size() - i_);
+	}
+
+private:
+	std::vector<T> v_;
+	size_t i_;
+};
+
+inline std::string default_tmp_dir() {
+	const char *dir = getenv("TMPDIR");
+	return dir == nullptr || *dir == '\0' ? "/tmp" : dir;
+}
+
+} // namespace detail
+
+// Sorts a stream of items that may not fit in memory.
+//
+// At most "max_items" items are kept in a MinHeap. Runs are formed by
+// replacement selection: when the heap is full, its minimum is written to the
+// current run and replaced by the new item, which joins the current run if it
+// is not less than the written one, or the next run otherwise. For random
+// input, runs are about twice as long as "max_items". Runs are spilled to
+// anonymous temporary files in "dir" with buffered sequential I/O, and merged
+// by MergingIterator. The last run is not spilled but merged from memory.
+//
+// At most kMaxFanIn runs are merged at a time. Spilled runs are kept like the
+// digits of a counter in base kMaxFanIn: once there are kMaxFanIn runs of the
+// same level, they are merged into one run of the next level. Before the
+// final merge, the smallest runs are merged until at most kMaxFanIn sources
+// are left. Therefore, besides the "max_items" items in memory, at most
+// kMaxFanIn + 1 stream buffers of SpillFile::kBufSize bytes are allocated at
+// a time, and the number of open files only grows with the logarithm of the
+// number of runs. Each intermediate pass writes the merged items once more.
+//
+// "Serde" has "void serialize(const T &, std::string &out)" that appends the
+// bytes of an item, and "T deserialize(const char *data, size_t len)".
+template <
+	typename T,
+	typename Serde = PodSerde<T>,
+	typename Compare = std::less<T>
+>
+class ExternalSorter {
+public:
+	static constexpr size_t kMaxFanIn = 16;
+
+	explicit ExternalSorter(
+		size_t max_items,
+		std::string dir = detail::default_tmp_dir(),
+		Serde serde = Serde(),
+		Compare cmp = Compare()
+	) : max_items_(max_items),
+		dir_(std::move(dir)),
+		serde_(std::move(serde)),
+		cmp_(cmp),
+		heap_({}, EntryCmp(std::move(cmp))) {
+		rusty_assert(max_items_ != 0);
+	}
+
+	io::Result<std::monostate> push(T x) {
+		if (heap_.len() < max_items_) {
+			heap_.push(Entry{run_, std::move(x)});
+			return std::monostate();
+		}
+		auto top = heap_.peek_mut().unwrap_unchecked();
+		rusty_check_result(spill(top->run, top->value));
+		size_t run = cmp_(x, top->value) ? top->run + 1 : top->run;
+		*top = Entry{run, std::move(x)};
+		return std::monostate();
+	}
+
+	// Returns the items in sorted order.
+	io::Result<std::unique_ptr<Peek<T>>> finish() && {
+		std::vector<std::unique_ptr<Peek<T>>> iters;
+		std::vector<T> last_run;
+		last_run.reserve(heap_.len());
+		for (;;) {
+			auto maybe_entry = heap_.pop();
+			if (maybe_entry.is_none()) {
+				break;
+			}
+			auto entry = std::move(maybe_entry).unwrap_unchecked();
+			if (out_.is_some() && entry.run == run_) {
+				// The rest of the run on disk.
+				rusty_check_result(spill(entry.run, entry.value));
+			} else {
+				last_run.push_back(std::move(entry.value));
+			}
+		}
+		rusty_check_result(finish_run());
+		// Leaves room for the last run.
+		while (runs_.size() + 1 > kMaxFanIn) {
+			rusty_check_result(merge_tail(
+				std::min(kMaxFanIn, runs_.size() + 2 - kMaxFanIn)
+			));
+		}
+		for (auto &run : runs_) {
+			iters.push_back(NewPeek(MakePeekable(
+				detail::SpillReader<T, Serde>(std::move(run.file), serde_)
+			)));
+		}
+		iters.push_back(NewPeek(MakePeekable(
+			detail::VecIntoIter<T>(std::move(last_run))
+		)));
+		return NewPeek(MakePeekable(
+			NewMergingIterator(std::move(iters), std::move(cmp_))
+		));
+	}
+
+	// The number of runs formed by replacement selection and spilled so far.
+	// The runs written by intermediate merges are not counted.
+	size_t spilled_runs() const {
+		return spilled_runs_;
+	}
+
+private:
+	class Entry {
+	public:
+		size_t run;
+		T value;
+	};
+
+	class Run {
+	public:
+		detail::SpillFile file;
+		// 0 for the runs of replacement selection, and one more than the
+		// highest merged level for the output of a merge.
+		size_t level;
+	};
+
+	class EntryCmp {
+	public:
+		explicit EntryCmp(Compare cmp) : cmp_(std::move(cmp)) {}
+		bool operator()(const Entry &a, const Entry &b) {
+			if (a.run != b.run) {
+				return a.run < b.run;
+			}
+			return cmp_(a.value, b.value);
+		}
+
+	private:
+		Compare cmp_;
+	};
+
+	// Appends "x" to "run", which is either the current run or the next one.
+	io::Result<std::monostate> spill(size_t run, const T &x) {
+		if (out_.is_none() || run != run_) {
+			rusty_check_result(finish_run());
+			out_ = rusty_check_result(detail::SpillFile::create(dir_));
+			run_ = run;
+			++spilled_runs_;
+		}
+		frame_.clear();
+		serde_.serialize(x, frame_);
+		return out_.as_ptr()->write(frame_);
+	}
+	io::Result<std::monostate> finish_run() {
+		if (out_.is_none()) {
+			return std::monostate();
+		}
+		auto file = out_.take().unwrap_unchecked();
+		rusty_check_result(file.finish_write());
+		runs_.push_back(Run{std::move(file), 0});
+		// The levels never increase along runs_, so the last kMaxFanIn runs
+		// are of the same level if the first and the last of them are.
+		while (runs_.size() >= kMaxFanIn &&
+				runs_[runs_.size() - kMaxFanIn].level == runs_.back().level) {
+			rusty_check_result(merge_tail(kMaxFanIn));
+		}
+		return std::monostate();
+	}
+	// Merges the last "n" runs into one.
+	io::Result<std::monostate> merge_tail(size_t n) {
+		std::vector<std::unique_ptr<Peek<T>>> iters;
+		size_t level = 0;
+		for (size_t i = runs_.size() - n; i < runs_.size(); ++i) {
+			level = std::max(level, runs_[i].level + 1);
+			iters.push_back(NewPeek(MakePeekable(
+				detail::SpillReader<T, Serde>(std::move(runs_[i].file), serde_)
+			)));
+		}
+		runs_.erase(runs_.end() - n, runs_.end());
+		auto merged = rusty_check_result(detail::SpillFile::create(dir_));
+		auto iter = NewMergingIterator(std::move(iters), cmp_);
+		for (;;) {
+			auto x = iter->next();
+			if (x.is_none()) {
+				break;
+			}
+			frame_.clear();
+			serde_.serialize(*x.as_ptr(), frame_);
+			rusty_check_result(merged.write(frame_));
+		}
+		rusty_check_result(merged.finish_write());
+		runs_.push_back(Run{std::move(merged), level});
+		return std::monostate();
+	}
+
+	size_t max_items_;
+	std::string dir_;
+	Serde serde_;
+	Compare cmp_;
+	MinHeap<Entry, EntryCmp> heap_;
+	// The run that out_ is writing, or the first run if nothing is spilled.
+	size_t run_ = 0;
+	Option<detail::SpillFile> out_;
+	// Finished runs, ready for reading.
+	std::vector<Run> runs_;
+	size_t spilled_runs_ = 0;
+	std::string frame_;
+};
+
+} // namespace rusty
+
+#endif // RUSTY_EXTERNAL_SORT_H_
@@ -1,11 +1,15 @@
 #ifndef RUSTY_ITERATOR_H_
 #define RUSTY_ITERATOR_H_
 
+#include "rusty/macro.h"
 #include "rusty/option.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace rusty {
@@ -13,6 +17,116 @@ namespace rusty {
 template <typename T>
 struct type_tag_t {};
 
+template <typename T>
+class Iterator;
+template <typename T>
+class Seek;
+
+// The lower bound and the upper bound (None if unknown or overflowing) of the
+// number of remaining items.
+using SizeHint = std::pair<size_t, Option<size_t>>;
+
+namespace detail {
+
+template <typename I>
+size_t next_batch_by_next(
+	I &iter, std::vector<typename I::value_type> &out, size_t n
+) {
+	size_t i = 0;
+	for (; i < n; ++i) {
+		auto res = iter.next(type_tag_t<Iterator<typename I::value_type>>());
+		if (res.is_none()) {
+			break;
+		}
+		out.push_back(std::move(res).unwrap_unchecked());
+	}
+	return i;
+}
+
+template <typename I, typename = void>
+class HasNextBatch : public std::false_type {};
+
+template <typename I>
+class HasNextBatch<I, std::void_t<decltype(std::declval<I &>().next_batch(
+	type_tag_t<Iterator<typename I::value_type>>(),
+	std::declval<std::vector<typename I::value_type> &>(),
+	size_t()
+))>> : public std::true_type {};
+
+// Uses the native "next_batch" of "iter" if there is one, otherwise falls back
+// to calling "next" repeatedly.
+template <typename I>
+size_t next_batch(I &iter, std::vector<typename I::value_type> &out, size_t n) {
+	if constexpr (HasNextBatch<I>::value) {
+		return iter.next_batch(
+			type_tag_t<Iterator<typename I::value_type>>(), out, n
+		);
+	} else {
+		return next_batch_by_next(iter, out, n);
+	}
+}
+
+template <typename I, typename = void>
+class HasSizeHint : public std::false_type {};
+
+template <typename I>
+class HasSizeHint<I, std::void_t<decltype(std::declval<const I &>().size_hint(
+	type_tag_t<Iterator<typename I::value_type>>()
+))>> : public std::true_type {};
+
+// Uses the native "size_hint" of "iter" if there is one, otherwise knows
+// nothing.
+template <typename I>
+SizeHint size_hint(const I &iter) {
+	if constexpr (HasSizeHint<I>::value) {
+		return iter.size_hint(type_tag_t<Iterator<typename I::value_type>>());
+	} else {
+		return SizeHint(0, None);
+	}
+}
+
+// Iterators with "value_type next_unchecked()", which yields the next item
+// without checking for the end. Calling it on an exhausted iterator is
+// undefined behavior. Together with an exact size_hint, a consumer can check
+// the length once and then run a loop without per-item end checks, which the
+// compiler can optimize like an indexed loop.
+template <typename I, typename = void>
+class HasNextUnchecked : public std::false_type {};
+
+template <typename I>
+class HasNextUnchecked<I, std::void_t<
+	decltype(std::declval<I &>().next_unchecked())
+>> : public std::true_type {};
+
+// Returns the number of remaining items if the hint of "iter" is exact.
+template <typename I>
+Option<size_t> exact_len(const I &iter) {
+	auto [lower, upper] = size_hint(iter);
+	if (upper.is_some() && *upper.as_ptr() == lower) {
+		return lower;
+	}
+	return None;
+}
+
+// The hint of the concatenation of two iterators.
+inline SizeHint size_hint_add(const SizeHint &a, const SizeHint &b) {
+	size_t lower = a.first + b.first;
+	if (lower < a.first) {
+		lower = std::numeric_limits<size_t>::max();
+	}
+	Option<size_t> upper;
+	if (a.second.is_some() && b.second.is_some()) {
+		size_t ua = *a.second.as_ptr();
+		size_t ub = *b.second.as_ptr();
+		if (ua + ub >= ua) {
+			upper = ua + ub;
+		}
+	}
+	return SizeHint(lower, upper);
+}
+
+} // namespace detail
+
 // Trait object for TraitIterator
 template <typename T>
 class Iterator {
@@ -21,9 +135,31 @@ public:
 	virtual ~Iterator() = default;
 	virtual Option<T> next(type_tag_t<Iterator<value_type>>) = 0;
 
+	// Appends at most "n" items to "out" and returns the number of appended
+	// items, which is less than "n" only if the iterator is exhausted. It costs
+	// one virtual call per batch instead of one per item.
+	//
+	// Items that are only guaranteed to be alive until the next call to "next"
+	// are only guaranteed to be alive until the next item in the batch is
+	// produced, so only the last item of the batch is guaranteed to be alive.
+	virtual size_t next_batch(
+		type_tag_t<Iterator<value_type>>, std::vector<T> &out, size_t n
+	) {
+		return detail::next_batch_by_next(*this, out, n);
+	}
+	virtual SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return SizeHint(0, None);
+	}
+
 	Option<value_type> next() {
 		return next(type_tag_t<Iterator<value_type>>());
 	}
+	size_t next_batch(std::vector<T> &out, size_t n) {
+		return next_batch(type_tag_t<Iterator<value_type>>(), out, n);
+	}
+	SizeHint size_hint() const {
+		return size_hint(type_tag_t<Iterator<value_type>>());
+	}
 
 	template <typename I>
 	class FatPointer;
@@ -37,6 +173,14 @@ public:
 	Option<T> next(type_tag_t<Iterator<T>>) override {
 		return iter_.next(type_tag_t<Iterator<T>>());
 	}
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		return detail::next_batch(iter_, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return detail::size_hint(iter_);
+	}
 
 private:
 	I iter_;
@@ -49,6 +193,57 @@ std::unique_ptr<Iterator<typename I::value_type>> NewIterator(I &&iter) {
 	>(std::forward<I>(iter));
 }
 
+// Trait object for TraitDoubleEndedIterator
+//
+// "next_back" yields the items from the back. The front and the back meet in
+// the middle, so every item is yielded once in total.
+template <typename T>
+class DoubleEndedIterator : public Iterator<T> {
+public:
+	using value_type = T;
+	virtual Option<T> next_back(type_tag_t<DoubleEndedIterator<value_type>>) = 0;
+
+	Option<value_type> next_back() {
+		return next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+	}
+
+	template <typename I>
+	class FatPointer;
+};
+
+template <typename T>
+template <typename I>
+class DoubleEndedIterator<T>::FatPointer : public DoubleEndedIterator<T> {
+public:
+	explicit FatPointer(I &&iter) : iter_(std::move(iter)) {}
+	Option<T> next(type_tag_t<Iterator<T>>) override {
+		return iter_.next(type_tag_t<Iterator<T>>());
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		return detail::next_batch(iter_, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return detail::size_hint(iter_);
+	}
+	Option<T> next_back(type_tag_t<DoubleEndedIterator<T>>) override {
+		return iter_.next_back(type_tag_t<DoubleEndedIterator<T>>());
+	}
+
+private:
+	I iter_;
+};
+
+template <typename I>
+std::unique_ptr<DoubleEndedIterator<typename I::value_type>>
+NewDoubleEndedIterator(I &&iter) {
+	return std::make_unique<
+		typename DoubleEndedIterator<typename I::value_type>::template
+			FatPointer<I>
+	>(std::forward<I>(iter));
+}
+
 namespace detail {
 
 template <typename T>
@@ -69,6 +264,23 @@ public:
 	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
 		return iter_->next();
 	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		return iter_->next_batch(out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return iter_->size_hint();
+	}
+	template <
+		typename J = Iter,
+		typename = decltype(std::declval<J &>().next_back())
+	>
+	Option<value_type> next_back(type_tag_t<DoubleEndedIterator<value_type>>) {
+		return iter_->next_back();
+	}
 
 private:
 	std::unique_ptr<Iter> iter_;
@@ -80,15 +292,13 @@ template <typename I, typename = std::enable_if_t<!detail::IteratorImpl<I>::impl
 void collect_into(
 	I &&iter, std::vector<typename I::value_type> &v
 ) {
-	for (;;) {
-		auto res = iter.next(
-			type_tag_t<Iterator<typename I::value_type>>()
-		);
-		if (res.is_none()) {
-			break;
-		}
-		v.push_back(std::move(res).unwrap_unchecked());
+	// Grows geometrically, so that collecting many short iterators into the
+	// same vector stays amortized O(1) per item.
+	size_t lower = detail::size_hint(iter).first;
+	if (v.capacity() - v.size() < lower) {
+		v.reserve(std::max(v.size() + lower, v.capacity() * 2));
 	}
+	detail::next_batch(iter, v, std::numeric_limits<size_t>::max());
 }
 
 template <typename I, typename = std::enable_if_t<detail::IteratorImpl<I>::impl>>
@@ -100,6 +310,13 @@ void collect_into(
 
 namespace slice {
 
+template <typename T>
+class Copied;
+template <typename T>
+class Chunks;
+template <typename T>
+class Windows;
+
 template <typename T>
 class Iter {
 public:
@@ -113,6 +330,196 @@ public:
 		++it_;
 		return ret;
 	}
+	// The iterator must not be exhausted.
+	value_type next_unchecked() {
+		return ref(*it_++);
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		size_t len = std::min<size_t>(n, end_ - it_);
+		for (size_t i = 0; i < len; ++i) {
+			out.push_back(ref(it_[i]));
+		}
+		it_ += len;
+		return len;
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return SizeHint(len(), len());
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+	size_t next_batch(std::vector<value_type> &out, size_t n) {
+		return next_batch(type_tag_t<Iterator<value_type>>(), out, n);
+	}
+	SizeHint size_hint() const {
+		return size_hint(type_tag_t<Iterator<value_type>>());
+	}
+
+	// impl TraitDoubleEndedIterator
+	Option<value_type> next_back(type_tag_t<DoubleEndedIterator<value_type>>) {
+		if (it_ == end_) {
+			return None;
+		}
+		--end_;
+		return ref(*end_);
+	}
+	Option<value_type> next_back() {
+		return next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+	}
+
+	// impl TraitSeek without TraitPeek. Skips the elements less than "target".
+	// Gallops from the current position, so that a short skip costs
+	// O(log(skipped)) instead of O(log(len)).
+	void seek(type_tag_t<Seek<value_type>>, const value_type &target) {
+		const T &x = *target;
+		const T *lo = it_;
+		size_t step = 1;
+		while (step < static_cast<size_t>(end_ - lo) && lo[step - 1] < x) {
+			lo += step;
+			step *= 2;
+		}
+		const T *hi = lo + std::min<size_t>(step, end_ - lo);
+		it_ = std::lower_bound(lo, hi, x);
+	}
+	void seek(const value_type &target) {
+		seek(type_tag_t<Seek<value_type>>(), target);
+	}
+
+	// Returns a pointer to the remaining elements.
+	const T *as_ptr() const {
+		return it_;
+	}
+	// Returns the number of remaining elements.
+	size_t len() const {
+		return end_ - it_;
+	}
+	// The remaining elements as a range, e.g., for STL algorithms or loops that
+	// the compiler can vectorize.
+	const T *begin() const {
+		return it_;
+	}
+	const T *end() const {
+		return end_;
+	}
+
+	// Yields copies of the remaining elements.
+	Copied<T> copied() const {
+		return Copied<T>(it_, end_);
+	}
+	// Yields the remaining elements in sub-slices of "n" elements. The last
+	// one is shorter if "n" does not divide the length.
+	Chunks<T> chunks(size_t n) const {
+		return Chunks<T>(it_, end_, n);
+	}
+	// Yields every sub-slice of "n" consecutive remaining elements.
+	Windows<T> windows(size_t n) const {
+		return Windows<T>(it_, end_, n);
+	}
+
+private:
+	const T *it_;
+	const T *end_;
+};
+
+// Yields copies of the elements of a slice. Batches are copied with a single
+// insert, which is a memmove for trivially copyable "T".
+template <typename T>
+class Copied {
+public:
+	using value_type = T;
+	Copied(const T *start, const T *end) : it_(start), end_(end) {}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (it_ == end_) {
+			return None;
+		}
+		return *it_++;
+	}
+	// The iterator must not be exhausted.
+	value_type next_unchecked() {
+		return *it_++;
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		size_t len = std::min<size_t>(n, end_ - it_);
+		out.insert(out.end(), it_, it_ + len);
+		it_ += len;
+		return len;
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return SizeHint(end_ - it_, end_ - it_);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+	Option<value_type> next_back(type_tag_t<DoubleEndedIterator<value_type>>) {
+		if (it_ == end_) {
+			return None;
+		}
+		return *--end_;
+	}
+
+private:
+	const T *it_;
+	const T *end_;
+};
+
+template <typename T>
+class Chunks {
+public:
+	using value_type = Iter<T>;
+	Chunks(const T *start, const T *end, size_t n)
+	  : it_(start), end_(end), n_(n) {
+		rusty_assert(n != 0, "Chunk size must be positive");
+	}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (it_ == end_) {
+			return None;
+		}
+		const T *start = it_;
+		it_ += std::min<size_t>(n_, end_ - it_);
+		return Iter<T>(start, it_);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		size_t len = (end_ - it_ + n_ - 1) / n_;
+		return SizeHint(len, len);
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	const T *it_;
+	const T *end_;
+	size_t n_;
+};
+
+template <typename T>
+class Windows {
+public:
+	using value_type = Iter<T>;
+	Windows(const T *start, const T *end, size_t n)
+	  : it_(start), end_(end), n_(n) {
+		rusty_assert(n != 0, "Window size must be positive");
+	}
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if ((size_t)(end_ - it_) < n_) {
+			return None;
+		}
+		++it_;
+		return Iter<T>(it_ - 1, it_ - 1 + n_);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		size_t len = end_ - it_;
+		len = len < n_ ? 0 : len - n_ + 1;
+		return SizeHint(len, len);
+	}
 	Option<value_type> next() {
 		return next(type_tag_t<Iterator<value_type>>());
 	}
@@ -120,6 +527,7 @@ public:
 private:
 	const T *it_;
 	const T *end_;
+	size_t n_;
 };
 
 template <typename T>
@@ -0,0 +1,150 @@
+#ifndef RUSTY_LOSER_TREE_MERGING_ITERATOR_H_
+#define RUSTY_LOSER_TREE_MERGING_ITERATOR_H_
+
+#include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
+
+namespace rusty {
+
+// Same as MergingIterator, but backed by a tournament tree of losers instead
+// of a binary heap. Replacing the winner only replays the matches on the path
+// from its leaf to the root, which costs log2(k) comparisons per output
+// instead of the ~2 * log2(k) of a heap sift-down.
+template <typename T, typename Compare = std::less<T>>
+class LoserTreeMergingIterator : public Iterator<T> {
+public:
+	LoserTreeMergingIterator(LoserTreeMergingIterator<T, Compare> &&) = delete;
+	LoserTreeMergingIterator &operator=(
+		LoserTreeMergingIterator<T, Compare> &&rhs
+	) = delete;
+
+	explicit LoserTreeMergingIterator(
+		std::vector<std::unique_ptr<Peek<T>>> iters,
+		Compare cmp = Compare()
+	) : iters_(std::move(iters)), cmp_(std::move(cmp)) {
+		size_t k = iters_.size();
+		heads_.reserve(k);
+		for (const auto &it : iters_) {
+			heads_.push_back(it->peek());
+		}
+		build();
+	}
+
+	Option<T> next(type_tag_t<Iterator<T>>) override {
+		if (iters_.empty()) {
+			return None;
+		}
+		// Like MergingIterator, the winner is advanced lazily so that the
+		// value returned by the last call stays alive until this call.
+		size_t winner = tree_[0];
+		if (winner_taken_) {
+			heads_[winner] = iters_[winner]->peek();
+			winner = replay(winner);
+		}
+		if (heads_[winner] == nullptr) {
+			winner_taken_ = false;
+			return None;
+		}
+		winner_taken_ = true;
+		return iters_[winner]->next();
+	}
+
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		size_t i = 0;
+		for (; i < n; ++i) {
+			auto ret = LoserTreeMergingIterator::next(
+				type_tag_t<Iterator<T>>()
+			);
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked());
+		}
+		return i;
+	}
+
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		SizeHint sum(0, 0);
+		for (const auto &it : iters_) {
+			sum = detail::size_hint_add(sum, it->size_hint());
+		}
+		return sum;
+	}
+
+private:
+	// Exhausted iterators lose to everyone.
+	bool beats(size_t a, size_t b) {
+		const T *ax = heads_[a];
+		if (ax == nullptr) {
+			return false;
+		}
+		const T *bx = heads_[b];
+		if (bx == nullptr) {
+			return true;
+		}
+		return cmp_(*ax, *bx);
+	}
+
+	// tree_[1..k) are the internal nodes of a complete binary tree whose k
+	// leaves are the iterators, where leaf i is node k + i and the parent of
+	// node n is n / 2. Each internal node holds the loser of its match, and
+	// tree_[0] holds the overall winner.
+	void build() {
+		size_t k = iters_.size();
+		if (k == 0) {
+			return;
+		}
+		tree_.resize(k);
+		std::vector<size_t> winners(2 * k);
+		for (size_t i = 0; i < k; ++i) {
+			winners[k + i] = i;
+		}
+		for (size_t n = k - 1; n > 0; --n) {
+			size_t a = winners[2 * n];
+			size_t b = winners[2 * n + 1];
+			if (beats(b, a)) {
+				std::swap(a, b);
+			}
+			winners[n] = a;
+			tree_[n] = b;
+		}
+		tree_[0] = k == 1 ? 0 : winners[1];
+	}
+
+	// Replays the matches from the leaf of iterator "i" up to the root.
+	// Returns the new winner.
+	size_t replay(size_t i) {
+		size_t winner = i;
+		for (size_t n = (iters_.size() + i) / 2; n > 0; n /= 2) {
+			if (beats(tree_[n], winner)) {
+				std::swap(tree_[n], winner);
+			}
+		}
+		tree_[0] = winner;
+		return winner;
+	}
+
+	std::vector<std::unique_ptr<Peek<T>>> iters_;
+	// Cached results of "peek". They stay valid until the corresponding
+	// iterator is advanced, which only happens to the winner.
+	std::vector<const T *> heads_;
+	std::vector<size_t> tree_;
+	Compare cmp_;
+	bool winner_taken_ = false;
+};
+
+template <typename T, typename Compare = std::less<T>>
+std::unique_ptr<Iterator<T>> NewLoserTreeMergingIterator(
+	std::vector<std::unique_ptr<Peek<T>>> iters,
+	Compare cmp = Compare()
+) {
+	return std::make_unique<LoserTreeMergingIterator<T, Compare>>(
+		std::move(iters), std::move(cmp)
+	);
+}
+
+} // namespace rusty
+
+#endif // RUSTY_LOSER_TREE_MERGING_ITERATOR_H_
@@ -5,8 +5,90 @@
 #include "rusty/iter/iterator.h"
 #include "rusty/iter/peekable.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
 namespace rusty {
 
+// The first 8 bytes of "s" as a big-endian integer, padded with zeros. If the
+// prefix key of a string is smaller than that of another, then the string is
+// also smaller.
+inline uint64_t string_prefix_key(std::string_view s) {
+	uint64_t key = 0;
+	size_t n = std::min<size_t>(s.size(), 8);
+	for (size_t i = 0; i < n; ++i) {
+		key = key << 8 | static_cast<unsigned char>(s[i]);
+	}
+	return n == 0 ? 0 : key << (8 - n) * 8;
+}
+
+// A comparator that also provides "prefix_key". "KeyFn" maps an element to a
+// uint64_t that is consistent with "Compare", i.e., a smaller key means a
+// smaller element, e.g., string_prefix_key. MergingIterator caches the key of
+// the head of every source in the heap, and only runs "Compare" on ties.
+template <typename T, typename KeyFn, typename Compare = std::less<T>>
+class PrefixKeyCompare {
+public:
+	explicit PrefixKeyCompare(KeyFn key_fn, Compare cmp = Compare())
+	  : key_fn_(std::move(key_fn)), cmp_(std::move(cmp)) {}
+	uint64_t prefix_key(const T &x) {
+		return key_fn_(x);
+	}
+	bool operator()(const T &a, const T &b) {
+		return cmp_(a, b);
+	}
+
+private:
+	KeyFn key_fn_;
+	Compare cmp_;
+};
+
+template <typename T, typename KeyFn, typename Compare = std::less<T>>
+PrefixKeyCompare<T, KeyFn, Compare> MakePrefixKeyCompare(
+	KeyFn key_fn, Compare cmp = Compare()
+) {
+	return PrefixKeyCompare<T, KeyFn, Compare>(
+		std::move(key_fn), std::move(cmp)
+	);
+}
+
+// Reverses the order of "Compare", e.g., for MergingIterator to merge
+// descending sources into a descending sequence.
+template <typename Compare>
+class ReverseCompare {
+public:
+	explicit ReverseCompare(Compare cmp = Compare()) : cmp_(std::move(cmp)) {}
+	template <typename T>
+	bool operator()(const T &a, const T &b) {
+		return cmp_(b, a);
+	}
+
+private:
+	Compare cmp_;
+};
+
+namespace detail {
+
+template <typename Compare, typename T, typename = void>
+class HasPrefixKey : public std::false_type {};
+
+template <typename Compare, typename T>
+class HasPrefixKey<Compare, T, std::void_t<decltype(
+	std::declval<Compare &>().prefix_key(std::declval<const T &>())
+)>> : public std::true_type {};
+
+template <bool kPrefixKey>
+class MergeNodeKey {};
+
+template <>
+class MergeNodeKey<true> {
+public:
+	uint64_t key;
+};
+
+} // namespace detail
+
 template <typename T, typename Compare = std::less<T>>
 class MergingIterator : public Iterator<T> {
 public:
@@ -17,17 +99,40 @@ public:
 	explicit MergingIterator(
 		std::vector<std::unique_ptr<Peek<T>>> iters,
 		Compare cmp = Compare()
-	) : heap_(
-			(eraseEmptyIters(iters), std::move(iters)), IterCmp(std::move(cmp))
-		)
-	{}
+	) : remaining_(size_hint_sum(iters)),
+		cmp_(std::move(cmp)),
+		heap_({}, NodeCmp(cmp_))
+	{
+		std::vector<Node> nodes;
+		nodes.reserve(iters.size());
+		for (auto &it : iters) {
+			const T *head = it->peek();
+			if (head != nullptr) {
+				nodes.push_back(make_node(head, std::move(it)));
+			}
+		}
+		heap_.extend(std::move(nodes));
+	}
+
+	~MergingIterator() {
+		// The cached head of the top is stale, so remove the top without
+		// comparing it.
+		auto top = heap_top_.take();
+		if (top.is_some()) {
+			std::move(top).unwrap_unchecked().pop();
+		}
+	}
 
 	Option<T> next(type_tag_t<Iterator<T>>) override {
 		auto maybe_top = heap_top_.take();
 		if (maybe_top.is_some()) {
 			auto top = std::move(maybe_top).unwrap_unchecked();
-			if ((*top)->peek() == nullptr) {
+			const T *head = top->iter->peek();
+			if (head == nullptr) {
 				std::move(top).pop();
+			} else {
+				// Refresh the cached head before the heap sifts it down.
+				set_head(*top, head);
 			}
 		}
 		heap_top_ = heap_.peek_mut();
@@ -35,52 +140,98 @@ public:
 		if (top_ptr == nullptr) {
 			return None;
 		}
-		auto &it = **top_ptr;
+		auto &it = (*top_ptr)->iter;
+		if (remaining_.first != 0) {
+			--remaining_.first;
+		}
+		if (remaining_.second.is_some()) {
+			--*remaining_.second.as_ptr();
+		}
 		return it->next();
 	}
 
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		size_t i = 0;
+		for (; i < n; ++i) {
+			// Qualified so that the call is devirtualized and inlined.
+			auto ret = MergingIterator::next(type_tag_t<Iterator<T>>());
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked());
+		}
+		return i;
+	}
+
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return remaining_;
+	}
+
 private:
 	using I = std::unique_ptr<Peek<T>>;
 
-	class IterCmp {
+	static constexpr bool kPrefixKey = detail::HasPrefixKey<Compare, T>::value;
+
+	// Caches the head of the source, so that comparisons don't call the
+	// virtual "peek". If the comparator provides "prefix_key", the key of the
+	// head is cached too.
+	class Node : public detail::MergeNodeKey<kPrefixKey> {
+	public:
+		const T *head;
+		I iter;
+	};
+
+	class NodeCmp {
 	public:
-		explicit IterCmp(Compare cmp) : cmp_(std::move(cmp)) {}
-		bool operator()(const I &a, const I &b) {
-			const T *ax = a->peek();
-			assert(ax != nullptr);
-			const T *bx = b->peek();
-			assert(bx != nullptr);
-			return cmp_(*ax, *bx);
+		explicit NodeCmp(Compare &cmp) : cmp_(&cmp) {}
+		bool operator()(const Node &a, const Node &b) {
+			if constexpr (kPrefixKey) {
+				if (a.key != b.key) {
+					return a.key < b.key;
+				}
+			}
+			return (*cmp_)(*a.head, *b.head);
 		}
 
 	private:
-		Compare cmp_;
+		Compare *cmp_;
 	};
 
-	static void eraseEmptyIters(
-		std::vector<std::unique_ptr<Peek<T>>>& iters
-	) {
-		// Use erase_if after upgrading to C++20
-		size_t i = 0;
-		for (size_t j = 0; j < iters.size(); ++j) {
-			if (iters[j]->peek() != nullptr) {
-				if (i != j) {
-					iters[i] = std::move(iters[j]);
-					iters[j] = nullptr;
-				}
-				++i;
-			}
+	void set_head(Node &node, const T *head) {
+		node.head = head;
+		if constexpr (kPrefixKey) {
+			node.key = cmp_.prefix_key(*head);
+		}
+	}
+	Node make_node(const T *head, I iter) {
+		Node node;
+		node.iter = std::move(iter);
+		set_head(node, head);
+		return node;
+	}
+
+	static SizeHint size_hint_sum(const std::vector<I> &iters) {
+		SizeHint sum(0, 0);
+		for (const auto &it : iters) {
+			sum = detail::size_hint_add(sum, it->size_hint());
 		}
-		iters.resize(i);
+		return sum;
 	}
 
-	MinHeap<I, IterCmp> heap_;
+	// The heap is frozen between calls, so the hint is the sum of the hints of
+	// the sources at construction, minus the number of yielded items.
+	SizeHint remaining_;
+	// Referenced by the comparator of heap_.
+	Compare cmp_;
+	MinHeap<Node, NodeCmp> heap_;
 	// It is a common practice in C++ for iterators to keep the returned value
 	// alive until the next call to "next" or "peek". Therefore, we keep PeekMut
 	// here to freeze the heap until the next call to "next", so that the heap
 	// won't peek the underlying iterator and invalidate the returned value
 	// in the meantime.
-	Option<typename MinHeap<I, IterCmp>::PeekMut> heap_top_;
+	Option<typename MinHeap<Node, NodeCmp>::PeekMut> heap_top_;
 };
 
 template <typename T, typename Compare = std::less<T>>
@@ -93,6 +244,19 @@ std::unique_ptr<Iterator<T>> NewMergingIterator(
 	);
 }
 
+// Merges sources that are descending in the order of "cmp" into a descending
+// sequence, e.g., the sources are MakeRev(slice::MakeIter(v)) of ascending
+// vectors. It is a max-heap merge with the same cost as the ascending one.
+template <typename T, typename Compare = std::less<T>>
+std::unique_ptr<Iterator<T>> NewReverseMergingIterator(
+	std::vector<std::unique_ptr<Peek<T>>> iters,
+	Compare cmp = Compare()
+) {
+	return NewMergingIterator(
+		std::move(iters), ReverseCompare<Compare>(std::move(cmp))
+	);
+}
+
 } // namespace rusty
 
 #endif // RUSTY_MERGING_ITERATOR_H_
@@ -0,0 +1,180 @@
+#ifndef RUSTY_PARALLEL_MERGE_H_
+#define RUSTY_PARALLEL_MERGE_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/iter/iterator.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace rusty {
+
+namespace detail {
+
+template <typename T>
+class SortedRun {
+public:
+	const T *it;
+	const T *end;
+};
+
+template <typename T, typename Compare>
+class SortedRunCmp {
+public:
+	explicit SortedRunCmp(Compare cmp) : cmp_(std::move(cmp)) {}
+	bool operator()(const SortedRun<T> &a, const SortedRun<T> &b) {
+		return cmp_(*a.it, *b.it);
+	}
+
+private:
+	Compare cmp_;
+};
+
+// Merges the non-empty "runs" into "out".
+template <typename T, typename Compare>
+void merge_runs(std::vector<SortedRun<T>> runs, T *out, Compare cmp) {
+	auto heap = MakeMinHeap(
+		std::move(runs), SortedRunCmp<T, Compare>(std::move(cmp))
+	);
+	for (;;) {
+		auto maybe_top = heap.peek_mut();
+		if (maybe_top.is_none()) {
+			break;
+		}
+		auto top = std::move(maybe_top).unwrap_unchecked();
+		*out = *top->it;
+		++out;
+		++top->it;
+		if (top->it == top->end) {
+			std::move(top).pop();
+		}
+	}
+}
+
+// Joins the threads when destroyed, so that no joinable thread is left behind
+// if the calling thread throws.
+class JoinGuard {
+public:
+	~JoinGuard() {
+		for (auto &thread : threads) {
+			thread.join();
+		}
+	}
+	std::vector<std::thread> threads;
+};
+
+} // namespace detail
+
+// Merges the sorted "runs" into "out" with up to "threads" threads.
+//
+// The key space is split into one range per thread by splitters sampled
+// from the inputs in proportion to their lengths. Each run is cut at the
+// splitters with binary search, so every thread merges a disjoint slice of
+// every run into its own disjoint region of "out". Since an element belongs to
+// the range of the first splitter that is greater than it, equal elements
+// always end up in the same range.
+//
+// "T" must be default constructible and copy assignable. "out" is resized to
+// the total length of the runs. If the comparator or the assignment of "T"
+// throws in any thread, all threads are joined and the first exception is
+// rethrown, leaving "out" partially merged.
+template <typename T, typename Compare = std::less<T>>
+void parallel_merge_into(
+	const std::vector<slice::Iter<T>> &runs,
+	std::vector<T> &out,
+	size_t threads = std::thread::hardware_concurrency(),
+	Compare cmp = Compare()
+) {
+	// Below this, splitting is not worth spawning a thread.
+	constexpr size_t kMinPerThread = 1 << 14;
+	// Samples per thread, more samples make the ranges more even.
+	constexpr size_t kOversampling = 64;
+
+	size_t total = 0;
+	for (const auto &run : runs) {
+		total += run.len();
+	}
+	out.resize(total);
+	threads = std::max<size_t>(1, std::min(threads, total / kMinPerThread));
+
+	// Pick "threads - 1" splitters. Sampling every "step"-th element of the
+	// concatenation of the runs makes each run contribute samples in
+	// proportion to its length.
+	std::vector<T> splitters;
+	if (threads > 1) {
+		std::vector<T> samples;
+		size_t step = std::max<size_t>(1, total / (threads * kOversampling));
+		size_t skip = step / 2;
+		for (const auto &run : runs) {
+			size_t i = skip;
+			for (; i < run.len(); i += step) {
+				samples.push_back(run.as_ptr()[i]);
+			}
+			skip = i - run.len();
+		}
+		std::sort(samples.begin(), samples.end(), cmp);
+		for (size_t i = 1; i < threads; ++i) {
+			splitters.push_back(samples[i * samples.size() / threads]);
+		}
+	}
+
+	// cuts[i][j] is where the range of thread i starts in run j.
+	std::vector<std::vector<const T *>> cuts(threads + 1);
+	for (const auto &run : runs) {
+		const T *start = run.as_ptr();
+		const T *end = start + run.len();
+		cuts[0].push_back(start);
+		for (size_t i = 1; i < threads; ++i) {
+			cuts[i].push_back(
+				std::lower_bound(start, end, splitters[i - 1], cmp)
+			);
+		}
+		cuts[threads].push_back(end);
+	}
+
+	// Exceptions can't escape a thread, so each range keeps its own.
+	std::vector<std::exception_ptr> errors(threads);
+	auto merge_range = [&](size_t i, T *dst) {
+		try {
+			std::vector<detail::SortedRun<T>> parts;
+			for (size_t j = 0; j < runs.size(); ++j) {
+				if (cuts[i][j] != cuts[i + 1][j]) {
+					parts.push_back({cuts[i][j], cuts[i + 1][j]});
+				}
+			}
+			detail::merge_runs(std::move(parts), dst, cmp);
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	{
+		// Declared after everything the workers use, so that they are joined
+		// before it is destroyed.
+		detail::JoinGuard workers;
+		T *dst = out.data();
+		for (size_t i = 0; i < threads; ++i) {
+			size_t len = 0;
+			for (size_t j = 0; j < runs.size(); ++j) {
+				len += cuts[i + 1][j] - cuts[i][j];
+			}
+			if (i + 1 == threads) {
+				// The calling thread merges the last range itself.
+				merge_range(i, dst);
+			} else {
+				workers.threads.emplace_back(merge_range, i, dst);
+			}
+			dst += len;
+		}
+	}
+	for (const auto &error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+} // namespace rusty
+
+#endif // RUSTY_PARALLEL_MERGE_H_
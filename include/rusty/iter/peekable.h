@@ -31,6 +31,14 @@ public:
 	Option<T> next(type_tag_t<Iterator<T>>) override {
 		return iter_.next(type_tag_t<Iterator<T>>());
 	}
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		return detail::next_batch(iter_, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return detail::size_hint(iter_);
+	}
 	const T *peek(type_tag_t<Peek<T>>) override {
 		return iter_.peek(type_tag_t<Peek<T>>());
 	}
@@ -60,9 +68,36 @@ public:
 		}
 		return iter_.next(type_tag_t<Iterator<value_type>>());
 	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		if (n == 0) {
+			return 0;
+		}
+		size_t taken = 0;
+		if (peeked_.is_some()) {
+			out.push_back(peeked_.take().unwrap_unchecked());
+			taken = 1;
+		}
+		return taken + detail::next_batch(iter_, out, n - taken);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		if (peeked_.is_none()) {
+			return detail::size_hint(iter_);
+		}
+		return detail::size_hint_add(SizeHint(1, 1), detail::size_hint(iter_));
+	}
 	Option<value_type> next() {
 		return next(type_tag_t<Iterator<value_type>>());
 	}
+	size_t next_batch(std::vector<value_type> &out, size_t n) {
+		return next_batch(type_tag_t<Iterator<value_type>>(), out, n);
+	}
+	SizeHint size_hint() const {
+		return size_hint(type_tag_t<Iterator<value_type>>());
+	}
 
 	const value_type *peek(type_tag_t<Peek<value_type>>) {
 		auto peeked = peeked_.as_ptr();
@@ -76,6 +111,58 @@ public:
 		return peek(type_tag_t<Peek<value_type>>());
 	}
 
+	// impl TraitDoubleEndedIterator if "I" implements "next_back". The peeked
+	// item is the front, so it is the last one yielded from the back.
+	template <
+		typename J = I,
+		typename = decltype(std::declval<J &>().next_back(
+			type_tag_t<DoubleEndedIterator<value_type>>()
+		))
+	>
+	Option<value_type> next_back(type_tag_t<DoubleEndedIterator<value_type>>) {
+		auto ret = iter_.next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+		if (ret.is_some()) {
+			return ret;
+		}
+		return peeked_.take();
+	}
+	template <
+		typename J = I,
+		typename = decltype(std::declval<J &>().next_back(
+			type_tag_t<DoubleEndedIterator<value_type>>()
+		))
+	>
+	Option<value_type> next_back() {
+		return next_back(type_tag_t<DoubleEndedIterator<value_type>>());
+	}
+
+	// impl TraitSeek if "I" implements "seek".
+	template <
+		typename J = I,
+		typename = decltype(std::declval<J &>().seek(
+			type_tag_t<Seek<value_type>>(), std::declval<const value_type &>()
+		))
+	>
+	void seek(type_tag_t<Seek<value_type>>, const value_type &target) {
+		auto peeked = peeked_.as_ptr();
+		if (peeked != nullptr) {
+			if (!(*peeked < target)) {
+				return;
+			}
+			peeked_ = None;
+		}
+		iter_.seek(type_tag_t<Seek<value_type>>(), target);
+	}
+	template <
+		typename J = I,
+		typename = decltype(std::declval<J &>().seek(
+			type_tag_t<Seek<value_type>>(), std::declval<const value_type &>()
+		))
+	>
+	void seek(const value_type &target) {
+		seek(type_tag_t<Seek<value_type>>(), target);
+	}
+
 private:
 	I iter_;
 	Option<value_type> peeked_;
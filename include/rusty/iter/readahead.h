@@ -0,0 +1,130 @@
+#ifndef RUSTY_READAHEAD_H_
+#define RUSTY_READAHEAD_H_
+
+#include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
+#include "rusty/sync/channel.h"
+
+#include <thread>
+
+namespace rusty {
+
+// impl TraitPeek
+//
+// Runs the wrapped iterator on a background thread, which keeps up to
+// "capacity" items ready, so that a slow producer (e.g., decompression or
+// file reads) does not block the consumer.
+//
+// Since items are produced ahead of time, the items of the wrapped iterator
+// must stay valid after it is advanced, e.g., owned values or references into
+// storage that outlives the iterator.
+template <typename I>
+class Readahead {
+public:
+	using value_type = typename I::value_type;
+
+	explicit Readahead(I &&iter, size_t capacity = 1024)
+	  : Readahead(std::move(iter), sync::spsc::channel<value_type>(capacity)) {}
+	Readahead(Readahead &&) = default;
+	Readahead &operator=(Readahead &&) = delete;
+	~Readahead() {
+		if (!thread_.joinable()) {
+			return;
+		}
+		// Dropping the receiver makes the pending "send" of the background
+		// thread fail, so that it stops.
+		{ auto rx = std::move(rx_); }
+		thread_.join();
+	}
+
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (peeked_.is_some()) {
+			return peeked_.take();
+		}
+		return rx_.recv();
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		size_t taken = 0;
+		while (taken < n) {
+			auto ret = next(type_tag_t<Iterator<value_type>>());
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked());
+			++taken;
+			// Take what is already available without blocking.
+			for (; taken < n; ++taken) {
+				auto item = rx_.try_recv();
+				if (item.is_err()) {
+					break;
+				}
+				out.push_back(std::move(item).unwrap_unchecked());
+			}
+		}
+		return taken;
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+	size_t next_batch(std::vector<value_type> &out, size_t n) {
+		return next_batch(type_tag_t<Iterator<value_type>>(), out, n);
+	}
+
+	const value_type *peek(type_tag_t<Peek<value_type>>) {
+		auto peeked = peeked_.as_ptr();
+		if (peeked != nullptr) {
+			return peeked;
+		}
+		peeked_ = rx_.recv();
+		return peeked_.as_ptr();
+	}
+	const value_type *peek() {
+		return peek(type_tag_t<Peek<value_type>>());
+	}
+
+private:
+	Readahead(
+		I &&iter,
+		std::pair<
+			sync::spsc::Sender<value_type>, sync::spsc::Receiver<value_type>
+		> channel
+	) : rx_(std::move(channel.second)),
+		thread_([iter = std::move(iter), tx = std::move(channel.first)]()
+				mutable {
+			for (;;) {
+				auto ret = iter.next(type_tag_t<Iterator<value_type>>());
+				if (ret.is_none()) {
+					break;
+				}
+				if (tx.send(std::move(ret).unwrap_unchecked()).is_err()) {
+					break;
+				}
+			}
+		}) {}
+
+	sync::spsc::Receiver<value_type> rx_;
+	std::thread thread_;
+	Option<value_type> peeked_;
+};
+
+template <typename I, typename = std::enable_if_t<!detail::IteratorImpl<I>::impl>>
+Readahead<I> MakeReadahead(I &&iter, size_t capacity = 1024) {
+	return Readahead<I>(std::forward<I>(iter), capacity);
+}
+
+template <typename I, typename = std::enable_if_t<detail::IteratorImpl<I>::impl>>
+Readahead<detail::IteratorImpl<I>> MakeReadahead(
+	I &&iter, size_t capacity = 1024
+) {
+	return MakeReadahead(
+		detail::IteratorImpl<I>(std::forward<I>(iter)), capacity
+	);
+}
+
+} // namespace rusty
+
+#endif // RUSTY_READAHEAD_H_
@@ -0,0 +1,199 @@
+#ifndef RUSTY_REDUCING_MERGING_ITERATOR_H_
+#define RUSTY_REDUCING_MERGING_ITERATOR_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
+
+namespace rusty {
+
+// Reducer of ReducingMergingIterator that keeps the element from the newest
+// source.
+class KeepNewest {
+public:
+	template <typename T>
+	T operator()(T newer, T) const {
+		return newer;
+	}
+};
+
+// Merges the sorted sources like MergingIterator, but yields one element per
+// group of equal elements, which is the fold of the group with "reduce":
+//
+//     reduce(... reduce(reduce(x0, x1), x2) ..., xn)
+//
+// where x0 is the newest element of the group. Sources with smaller indices
+// are newer, and within a source, earlier elements are newer. E.g., with
+// KeepNewest, only the element from the source with the smallest index is
+// kept, and a reducer that adds up the values of (key, value) pairs sums the
+// group.
+//
+// "equal" must agree with "cmp", i.e., equal elements are equivalent under
+// "cmp". Since a group is consumed as a whole, the items of the sources must
+// stay valid after the sources are advanced, e.g., owned values or references
+// into storage that outlives the iterator.
+template <
+	typename T,
+	typename Reduce = KeepNewest,
+	typename Compare = std::less<T>,
+	typename Equal = std::equal_to<T>
+>
+class ReducingMergingIterator : public Iterator<T> {
+public:
+	explicit ReducingMergingIterator(
+		std::vector<std::unique_ptr<Peek<T>>> iters,
+		Reduce reduce = Reduce(),
+		Compare cmp = Compare(),
+		Equal equal = Equal()
+	) : remaining_(size_hint_sum(iters)),
+		reduce_(std::move(reduce)),
+		equal_(std::move(equal)),
+		heap_({}, NodeCmp(std::move(cmp)))
+	{
+		std::vector<Node> nodes;
+		nodes.reserve(iters.size());
+		for (size_t i = 0; i < iters.size(); ++i) {
+			const T *head = iters[i]->peek();
+			if (head != nullptr) {
+				nodes.push_back(Node{head, i, std::move(iters[i])});
+			}
+		}
+		heap_.extend(std::move(nodes));
+	}
+
+	Option<T> next(type_tag_t<Iterator<T>>) override {
+		const Node *top = heap_.peek();
+		if (top == nullptr) {
+			return None;
+		}
+		// The group is collected first and then ordered by the source index,
+		// which is cheaper than breaking ties by the index in every heap
+		// comparison.
+		do {
+			size_t index = top->index;
+			group_.emplace_back(
+				index, advance(heap_.peek_mut().unwrap_unchecked())
+			);
+			top = heap_.peek();
+		} while (top != nullptr && equal_(*top->head, group_.front().second));
+		sort_group();
+		T acc = std::move(group_.front().second);
+		for (size_t i = 1; i < group_.size(); ++i) {
+			acc = reduce_(std::move(acc), std::move(group_[i].second));
+		}
+		group_.clear();
+		return acc;
+	}
+
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		size_t i = 0;
+		for (; i < n; ++i) {
+			// Qualified so that the call is devirtualized and inlined.
+			auto ret = ReducingMergingIterator::next(type_tag_t<Iterator<T>>());
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked());
+		}
+		return i;
+	}
+
+	// Any number of elements may be reduced away, so the lower bound is 1 if
+	// there is any element left.
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return SizeHint(heap_.is_empty() ? 0 : 1, remaining_.second);
+	}
+
+private:
+	using I = std::unique_ptr<Peek<T>>;
+
+	class Node {
+	public:
+		// Cached, so that comparisons don't call the virtual "peek".
+		const T *head;
+		size_t index;
+		I iter;
+	};
+
+	class NodeCmp {
+	public:
+		explicit NodeCmp(Compare cmp) : cmp_(std::move(cmp)) {}
+		bool operator()(const Node &a, const Node &b) {
+			return cmp_(*a.head, *b.head);
+		}
+
+	private:
+		Compare cmp_;
+	};
+
+	// Takes the head of the top source, and restores the heap.
+	T advance(typename MinHeap<Node, NodeCmp>::PeekMut top) {
+		T ret = top->iter->next().unwrap_unchecked();
+		if (remaining_.second.is_some()) {
+			--*remaining_.second.as_ptr();
+		}
+		const T *head = top->iter->peek();
+		if (head == nullptr) {
+			std::move(top).pop();
+		} else {
+			top->head = head;
+		}
+		return ret;
+	}
+
+	// Stable insertion sort by the source index, since groups are small and
+	// the elements of a source are already in order.
+	void sort_group() {
+		for (size_t i = 1; i < group_.size(); ++i) {
+			if (group_[i - 1].first <= group_[i].first) {
+				continue;
+			}
+			auto x = std::move(group_[i]);
+			size_t j = i;
+			for (; j > 0 && group_[j - 1].first > x.first; --j) {
+				group_[j] = std::move(group_[j - 1]);
+			}
+			group_[j] = std::move(x);
+		}
+	}
+
+	static SizeHint size_hint_sum(const std::vector<I> &iters) {
+		SizeHint sum(0, 0);
+		for (const auto &it : iters) {
+			sum = detail::size_hint_add(sum, it->size_hint());
+		}
+		return sum;
+	}
+
+	// The sum of the hints of the sources at construction, minus the number
+	// of consumed items.
+	SizeHint remaining_;
+	Reduce reduce_;
+	Equal equal_;
+	MinHeap<Node, NodeCmp> heap_;
+	// (source index, element) of the current group, reused across calls.
+	std::vector<std::pair<size_t, T>> group_;
+};
+
+template <
+	typename T,
+	typename Reduce = KeepNewest,
+	typename Compare = std::less<T>,
+	typename Equal = std::equal_to<T>
+>
+std::unique_ptr<Iterator<T>> NewReducingMergingIterator(
+	std::vector<std::unique_ptr<Peek<T>>> iters,
+	Reduce reduce = Reduce(),
+	Compare cmp = Compare(),
+	Equal equal = Equal()
+) {
+	return std::make_unique<ReducingMergingIterator<T, Reduce, Compare, Equal>>(
+		std::move(iters), std::move(reduce), std::move(cmp), std::move(equal)
+	);
+}
+
+} // namespace rusty
+
+#endif // RUSTY_REDUCING_MERGING_ITERATOR_H_
@@ -0,0 +1,64 @@
+#ifndef RUSTY_SEEK_H_
+#define RUSTY_SEEK_H_
+
+#include "rusty/iter/peekable.h"
+
+namespace rusty {
+
+// Trait object for TraitSeek
+//
+// "seek" skips the items that are less than "target" in the order of the
+// iterator, which is "operator<" for slice::Iter and Peekable. It only moves
+// forward: seeking to a target before the current position does nothing.
+template <typename T>
+class Seek : public Peek<T> {
+public:
+	static_assert(std::is_same_v<T, typename Peek<T>::value_type>);
+	using value_type = T;
+
+	virtual void seek(type_tag_t<Seek<value_type>>, const value_type &target) = 0;
+	void seek(const value_type &target) {
+		seek(type_tag_t<Seek<value_type>>(), target);
+	}
+
+	template <typename I>
+	class FatPointer;
+};
+
+template <typename T>
+template <typename I>
+class Seek<T>::FatPointer : public Seek<T> {
+public:
+	explicit FatPointer(I &&iter) : iter_(std::move(iter)) {}
+	Option<T> next(type_tag_t<Iterator<T>>) override {
+		return iter_.next(type_tag_t<Iterator<T>>());
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		return detail::next_batch(iter_, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return detail::size_hint(iter_);
+	}
+	const T *peek(type_tag_t<Peek<T>>) override {
+		return iter_.peek(type_tag_t<Peek<T>>());
+	}
+	void seek(type_tag_t<Seek<T>>, const T &target) override {
+		iter_.seek(type_tag_t<Seek<T>>(), target);
+	}
+
+private:
+	I iter_;
+};
+
+template <typename I>
+std::unique_ptr<Seek<typename I::value_type>> NewSeek(I &&iter) {
+	return std::make_unique<
+		typename Seek<typename I::value_type>::template FatPointer<I>
+	>(std::forward<I>(iter));
+}
+
+} // namespace rusty
+
+#endif // RUSTY_SEEK_H_
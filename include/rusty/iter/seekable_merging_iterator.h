@@ -0,0 +1,185 @@
+#ifndef RUSTY_SEEKABLE_MERGING_ITERATOR_H_
+#define RUSTY_SEEKABLE_MERGING_ITERATOR_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/iter/seek.h"
+
+namespace rusty {
+
+// impl TraitSeek
+//
+// Same as MergingIterator, but the sources and the merged iterator are
+// seekable. "seek" seeks the sources that are behind "target" and rebuilds
+// the heap in O(k), so that a range scan skips the prefix instead of draining
+// it. "Compare" must agree with the order of the sources.
+template <typename T, typename Compare = std::less<T>>
+class SeekableMergingIterator : public Seek<T> {
+public:
+	// PeekMut references heap_, so this class can't copy or move.
+	SeekableMergingIterator(SeekableMergingIterator<T, Compare> &&) = delete;
+	SeekableMergingIterator &operator=(
+		SeekableMergingIterator<T, Compare> &&rhs
+	) = delete;
+
+	explicit SeekableMergingIterator(
+		std::vector<std::unique_ptr<Seek<T>>> iters,
+		Compare cmp = Compare()
+	) : cmp_(std::move(cmp)), heap_({}, NodeCmp(cmp_)) {
+		std::vector<Node> nodes;
+		nodes.reserve(iters.size());
+		for (auto &it : iters) {
+			nodes.push_back(Node{nullptr, std::move(it)});
+		}
+		rebuild(std::move(nodes), nullptr);
+	}
+
+	~SeekableMergingIterator() {
+		// The cached head of the top is stale, so remove the top without
+		// comparing it.
+		auto top = heap_top_.take();
+		if (top.is_some()) {
+			std::move(top).unwrap_unchecked().pop();
+		}
+	}
+
+	Option<T> next(type_tag_t<Iterator<T>>) override {
+		settle();
+		heap_top_ = heap_.peek_mut();
+		auto top_ptr = heap_top_.as_ptr();
+		if (top_ptr == nullptr) {
+			return None;
+		}
+		if (remaining_.first != 0) {
+			--remaining_.first;
+		}
+		if (remaining_.second.is_some()) {
+			--*remaining_.second.as_ptr();
+		}
+		return (*top_ptr)->iter->next();
+	}
+
+	size_t next_batch(
+		type_tag_t<Iterator<T>>, std::vector<T> &out, size_t n
+	) override {
+		size_t i = 0;
+		for (; i < n; ++i) {
+			// Qualified so that the call is devirtualized and inlined.
+			auto ret = SeekableMergingIterator::next(type_tag_t<Iterator<T>>());
+			if (ret.is_none()) {
+				break;
+			}
+			out.push_back(std::move(ret).unwrap_unchecked());
+		}
+		return i;
+	}
+
+	SizeHint size_hint(type_tag_t<Iterator<T>>) const override {
+		return remaining_;
+	}
+
+	const T *peek(type_tag_t<Peek<T>>) override {
+		settle();
+		const Node *top = heap_.peek();
+		return top == nullptr ? nullptr : top->head;
+	}
+
+	void seek(type_tag_t<Seek<T>>, const T &target) override {
+		settle();
+		const Node *top = heap_.peek();
+		// Every head is not less than the top.
+		if (top == nullptr || !cmp_(*top->head, target)) {
+			return;
+		}
+		auto nodes = std::move(heap_).into_vec();
+		heap_ = MinHeap<Node, NodeCmp>({}, NodeCmp(cmp_));
+		rebuild(std::move(nodes), &target);
+	}
+
+private:
+	using I = std::unique_ptr<Seek<T>>;
+
+	// Caches the head of the source, so that comparisons don't call the
+	// virtual "peek".
+	class Node {
+	public:
+		const T *head;
+		I iter;
+	};
+
+	class NodeCmp {
+	public:
+		explicit NodeCmp(Compare &cmp) : cmp_(&cmp) {}
+		bool operator()(const Node &a, const Node &b) {
+			return (*cmp_)(*a.head, *b.head);
+		}
+
+	private:
+		Compare *cmp_;
+	};
+
+	// Advances the source yielded last time, so that the heap reflects the
+	// current heads again.
+	void settle() {
+		auto maybe_top = heap_top_.take();
+		if (maybe_top.is_none()) {
+			return;
+		}
+		auto top = std::move(maybe_top).unwrap_unchecked();
+		const T *head = top->iter->peek();
+		if (head == nullptr) {
+			std::move(top).pop();
+		} else {
+			top->head = head;
+		}
+	}
+
+	// Seeks the sources that are behind "target" if it is not null, and
+	// builds the heap from the non-empty sources.
+	void rebuild(std::vector<Node> nodes, const T *target) {
+		remaining_ = SizeHint(0, 0);
+		size_t n = 0;
+		for (auto &node : nodes) {
+			if (node.head == nullptr ||
+					(target != nullptr && cmp_(*node.head, *target))) {
+				if (target != nullptr) {
+					node.iter->seek(*target);
+				}
+				node.head = node.iter->peek();
+				if (node.head == nullptr) {
+					continue;
+				}
+			}
+			remaining_ = detail::size_hint_add(
+				remaining_, node.iter->size_hint()
+			);
+			nodes[n++] = std::move(node);
+		}
+		nodes.erase(nodes.begin() + n, nodes.end());
+		heap_.extend(std::move(nodes));
+	}
+
+	// The heap is frozen between calls, so the hint is the sum of the hints of
+	// the sources at construction or the last seek, minus the number of
+	// yielded items.
+	SizeHint remaining_;
+	// Referenced by the comparator of heap_.
+	Compare cmp_;
+	MinHeap<Node, NodeCmp> heap_;
+	// Freezes the heap until the next call, like MergingIterator, so that the
+	// returned value stays valid.
+	Option<typename MinHeap<Node, NodeCmp>::PeekMut> heap_top_;
+};
+
+template <typename T, typename Compare = std::less<T>>
+std::unique_ptr<Seek<T>> NewSeekableMergingIterator(
+	std::vector<std::unique_ptr<Seek<T>>> iters,
+	Compare cmp = Compare()
+) {
+	return std::make_unique<SeekableMergingIterator<T, Compare>>(
+		std::move(iters), std::move(cmp)
+	);
+}
+
+} // namespace rusty
+
+#endif // RUSTY_SEEKABLE_MERGING_ITERATOR_H_
@@ -0,0 +1,135 @@
+#ifndef RUSTY_STATIC_MERGING_ITERATOR_H_
+#define RUSTY_STATIC_MERGING_ITERATOR_H_
+
+#include "rusty/collections/min_heap.h"
+#include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
+
+namespace rusty {
+
+// impl TraitIterator
+//
+// Same as MergingIterator, but merges concrete peekable iterators of type "I"
+// (e.g., Peekable<slice::Iter<T>>) that are stored inline, so that "peek" and
+// "next" of the sources are not virtual calls and can be inlined into the
+// comparisons. The heap only holds the indices of the sources.
+template <typename I, typename Compare = std::less<typename I::value_type>>
+class StaticMergingIterator {
+public:
+	using value_type = typename I::value_type;
+
+	explicit StaticMergingIterator(
+		std::vector<I> iters, Compare cmp = Compare()
+	) : iters_(std::move(iters)),
+		remaining_(size_hint_sum(iters_)),
+		heap_(non_empty(iters_), IndexCmp(iters_.data(), std::move(cmp))) {}
+
+	Option<value_type> next(type_tag_t<Iterator<value_type>>) {
+		if (top_advanced_) {
+			top_advanced_ = false;
+			// Sifts the advanced source down, or pops it if it is exhausted.
+			auto top = heap_.peek_mut().unwrap_unchecked();
+			if (peek(*top) == nullptr) {
+				std::move(top).pop();
+			}
+		}
+		const size_t *top_ptr = heap_.peek();
+		if (top_ptr == nullptr) {
+			return None;
+		}
+		top_advanced_ = true;
+		if (remaining_.first != 0) {
+			--remaining_.first;
+		}
+		if (remaining_.second.is_some()) {
+			--*remaining_.second.as_ptr();
+		}
+		return iters_[*top_ptr].next(type_tag_t<Iterator<value_type>>());
+	}
+	size_t next_batch(
+		type_tag_t<Iterator<value_type>>,
+		std::vector<value_type> &out,
+		size_t n
+	) {
+		return detail::next_batch_by_next(*this, out, n);
+	}
+	SizeHint size_hint(type_tag_t<Iterator<value_type>>) const {
+		return remaining_;
+	}
+	Option<value_type> next() {
+		return next(type_tag_t<Iterator<value_type>>());
+	}
+	size_t next_batch(std::vector<value_type> &out, size_t n) {
+		return next_batch(type_tag_t<Iterator<value_type>>(), out, n);
+	}
+	SizeHint size_hint() const {
+		return size_hint(type_tag_t<Iterator<value_type>>());
+	}
+
+private:
+	class IndexCmp {
+	public:
+		IndexCmp(I *iters, Compare cmp) : iters_(iters), cmp_(std::move(cmp)) {}
+		bool operator()(size_t a, size_t b) {
+			const value_type *ax = iters_[a].peek(
+				type_tag_t<Peek<value_type>>()
+			);
+			assert(ax != nullptr);
+			const value_type *bx = iters_[b].peek(
+				type_tag_t<Peek<value_type>>()
+			);
+			assert(bx != nullptr);
+			return cmp_(*ax, *bx);
+		}
+
+	private:
+		// Points to the buffer of the vector, which stays in place when the
+		// vector is moved, so that this class can move.
+		I *iters_;
+		Compare cmp_;
+	};
+
+	const value_type *peek(size_t i) {
+		return iters_[i].peek(type_tag_t<Peek<value_type>>());
+	}
+
+	static std::vector<size_t> non_empty(std::vector<I> &iters) {
+		std::vector<size_t> ret;
+		ret.reserve(iters.size());
+		for (size_t i = 0; i < iters.size(); ++i) {
+			if (iters[i].peek(type_tag_t<Peek<value_type>>()) != nullptr) {
+				ret.push_back(i);
+			}
+		}
+		return ret;
+	}
+	static SizeHint size_hint_sum(const std::vector<I> &iters) {
+		SizeHint sum(0, 0);
+		for (const auto &it : iters) {
+			sum = detail::size_hint_add(sum, detail::size_hint(it));
+		}
+		return sum;
+	}
+
+	std::vector<I> iters_;
+	// The sum of the hints of the sources at construction, minus the number
+	// of yielded items.
+	SizeHint remaining_;
+	MinHeap<size_t, IndexCmp> heap_;
+	// Whether the source at the top was advanced by the last call to "next".
+	// Like MergingIterator, the heap is only fixed up at the next call, so
+	// that the returned value stays alive until then. A flag instead of a
+	// PeekMut keeps this class movable.
+	bool top_advanced_ = false;
+};
+
+template <typename I, typename Compare = std::less<typename I::value_type>>
+StaticMergingIterator<I, Compare> MakeStaticMergingIterator(
+	std::vector<I> iters, Compare cmp = Compare()
+) {
+	return StaticMergingIterator<I, Compare>(std::move(iters), std::move(cmp));
+}
+
+} // namespace rusty
+
+#endif // RUSTY_STATIC_MERGING_ITERATOR_H_
@@ -74,7 +74,9 @@ public:
 	Ref(T &v) : v_(&v) {}
 	Ref(std::reference_wrapper<T> v) : v_(&v.get()) {}
 
-	Ref(const Ref<T> &v) : v_(&v.deref()) {}
+	// Copy the pointer directly, since Option<Ref<T>> uses a null Ref as None.
+	Ref(const Ref<T> &v) : v_(v.v_) {}
+	Ref &operator=(const Ref<T> &v) = default;
 
 	T &operator*() const { return *v_; }
 	T *operator->() const { return v_; }
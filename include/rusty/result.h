@@ -40,7 +40,7 @@ public:
 } // namespace rusty
 
 #define rusty_check_result_impl(name, expr) ({ \
-	auto && (name) = (expr); \
+	auto &&name = (expr); \
 	if ((name).is_err()) { \
 		return std::move(name).unwrap_err_unchecked(); \
 	} \
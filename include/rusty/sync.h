@@ -1,38 +1,133 @@
 #ifndef RUSTY_SYNC_H_
 #define RUSTY_SYNC_H_
 
+#include "rusty/intrinsics.h"
+#include "rusty/option.h"
+
+#include <array>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
 
 namespace rusty {
 namespace sync {
 
-template <typename T>
+template <typename T, typename RawMutex>
 class Mutex;
 
-template <typename T>
+template <typename T, typename RawMutex = std::mutex>
 class MutexGuard {
 public:
 	T &operator*() const { return data_.get(); }
 	T *operator->() const { return &data_.get(); }
 private:
 	MutexGuard(
-		T &data, std::unique_lock<std::mutex> &&lock
+		T &data, std::unique_lock<RawMutex> &&lock
 	) : data_(data), lock_(std::move(lock)) {}
 	std::reference_wrapper<T> data_;
-	std::unique_lock<std::mutex> lock_;
-	friend class Mutex<T>;
+	std::unique_lock<RawMutex> lock_;
+	friend class Mutex<T, RawMutex>;
 };
 
-template <typename T>
+// "RawMutex" can be any type that meets the Lockable requirements, e.g.,
+// AdaptiveRawMutex in "rusty/sync/adaptive_mutex.h".
+template <typename T, typename RawMutex = std::mutex>
 class Mutex {
 public:
 	Mutex(T &&data) : data_(std::move(data)) {}
-	MutexGuard<T> lock() const {
-		return MutexGuard<T>(data_, std::unique_lock(lock_));
+	MutexGuard<T, RawMutex> lock() const {
+		return MutexGuard<T, RawMutex>(data_, std::unique_lock(lock_));
+	}
+	// Returns None if the lock is held by someone else.
+	Option<MutexGuard<T, RawMutex>> try_lock() const {
+		std::unique_lock lock(lock_, std::try_to_lock);
+		if (!lock.owns_lock()) {
+			return None;
+		}
+		return MutexGuard<T, RawMutex>(data_, std::move(lock));
+	}
+	const RawMutex &raw() const { return lock_; }
+private:
+	mutable T data_;
+	mutable RawMutex lock_;
+};
+
+template <typename T>
+class RwLock;
+
+// Shared access to the data of a RwLock.
+template <typename T>
+class ReadGuard {
+public:
+	const T &operator*() const { return data_.get(); }
+	const T *operator->() const { return &data_.get(); }
+private:
+	ReadGuard(
+		const T &data, std::shared_lock<std::shared_mutex> &&lock
+	) : data_(data), lock_(std::move(lock)) {}
+	std::reference_wrapper<const T> data_;
+	std::shared_lock<std::shared_mutex> lock_;
+	friend class RwLock<T>;
+};
+
+// Exclusive access to the data of a RwLock.
+template <typename T>
+class WriteGuard {
+public:
+	T &operator*() const { return data_.get(); }
+	T *operator->() const { return &data_.get(); }
+private:
+	WriteGuard(
+		T &data, std::unique_lock<std::shared_mutex> &&lock
+	) : data_(data), lock_(std::move(lock)) {}
+	std::reference_wrapper<T> data_;
+	std::unique_lock<std::shared_mutex> lock_;
+	friend class RwLock<T>;
+};
+
+// Allows any number of readers or one writer at a time.
+template <typename T>
+class RwLock {
+public:
+	RwLock() : data_() {}
+	RwLock(T &&data) : data_(std::move(data)) {}
+	ReadGuard<T> read() const {
+		return ReadGuard<T>(data_, std::shared_lock(lock_));
+	}
+	WriteGuard<T> write() const {
+		return WriteGuard<T>(data_, std::unique_lock(lock_));
 	}
 private:
 	mutable T data_;
-	mutable std::mutex lock_;
+	mutable std::shared_mutex lock_;
+};
+
+// "N" independently locked instances of "T", e.g., the shards of a map. A key
+// only goes to the shard selected by its hash, so that threads working on
+// different shards do not contend. Each shard is CachePadded.
+template <typename T, size_t N = 16>
+class ShardedRwLock {
+public:
+	ShardedRwLock() = default;
+
+	static constexpr size_t shards() { return N; }
+	const RwLock<T> &shard(size_t i) const { return *shards_[i]; }
+	template <typename K, typename Hash = std::hash<K>>
+	const RwLock<T> &shard_for(const K &key, Hash hash = Hash()) const {
+		return shard(hash(key) % N);
+	}
+
+	template <typename K, typename Hash = std::hash<K>>
+	ReadGuard<T> read(const K &key, Hash hash = Hash()) const {
+		return shard_for(key, std::move(hash)).read();
+	}
+	template <typename K, typename Hash = std::hash<K>>
+	WriteGuard<T> write(const K &key, Hash hash = Hash()) const {
+		return shard_for(key, std::move(hash)).write();
+	}
+
+private:
+	std::array<intrinsics::CachePadded<RwLock<T>>, N> shards_;
 };
 
 } // namespace sync
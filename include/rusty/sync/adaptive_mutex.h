@@ -0,0 +1,185 @@
+#ifndef RUSTY_SYNC_ADAPTIVE_MUTEX_H_
+#define RUSTY_SYNC_ADAPTIVE_MUTEX_H_
+
+#include "rusty/intrinsics.h"
+#include "rusty/sync.h"
+#include "rusty/time.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rusty {
+namespace sync {
+
+class MutexStats {
+public:
+	uint64_t acquisitions;
+	// Acquisitions that found the mutex locked.
+	uint64_t contended_acquisitions;
+	// Total time spent waiting in contended acquisitions.
+	time::Duration wait_time;
+};
+
+namespace detail {
+
+class MutexStatsCounters {
+public:
+	std::atomic<uint64_t> acquisitions{0};
+	std::atomic<uint64_t> contended_acquisitions{0};
+	std::atomic<uint64_t> wait_nanos{0};
+};
+class NoMutexStatsCounters {};
+
+#ifdef __linux__
+inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected) {
+	syscall(
+		SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE,
+		expected, nullptr, nullptr, 0
+	);
+}
+inline void futex_wake_one(std::atomic<uint32_t> &word) {
+	syscall(
+		SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE,
+		1, nullptr, nullptr, 0
+	);
+}
+#else
+// No futex, so waiters just yield until the word changes.
+inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected) {
+	if (word.load(std::memory_order_relaxed) == expected) {
+		std::this_thread::yield();
+	}
+}
+inline void futex_wake_one(std::atomic<uint32_t> &) {}
+#endif
+
+} // namespace detail
+
+// A raw mutex for short critical sections. A contended "lock" first spins
+// with exponential backoff, and only parks the thread on a futex if the
+// mutex is still locked after that, which avoids a round trip through the
+// kernel when the holder is about to release it.
+//
+// With "kStats", it also counts acquisitions and the time spent waiting, which
+// can be read with "stats". This costs an atomic increment per "lock".
+template <bool kStats = false>
+class AdaptiveRawMutex {
+public:
+	AdaptiveRawMutex() = default;
+	AdaptiveRawMutex(const AdaptiveRawMutex &) = delete;
+	AdaptiveRawMutex &operator=(const AdaptiveRawMutex &) = delete;
+
+	void lock() {
+		uint32_t c = kUnlocked;
+		if (state_.compare_exchange_strong(c, kLocked,
+				std::memory_order_acquire, std::memory_order_relaxed)) {
+			count(false, time::Duration());
+			return;
+		}
+		if constexpr (kStats) {
+			auto start = time::Instant::now();
+			lock_contended();
+			count(true, start.elapsed());
+		} else {
+			lock_contended();
+		}
+	}
+	bool try_lock() {
+		uint32_t c = kUnlocked;
+		bool locked = state_.compare_exchange_strong(c, kLocked,
+			std::memory_order_acquire, std::memory_order_relaxed);
+		if (locked) {
+			count(false, time::Duration());
+		}
+		return locked;
+	}
+	void unlock() {
+		if (state_.exchange(kUnlocked, std::memory_order_release) ==
+				kLockedWithWaiters) {
+			detail::futex_wake_one(state_);
+		}
+	}
+
+	MutexStats stats() const {
+		static_assert(kStats, "Stats are not enabled");
+		return MutexStats{
+			stats_.acquisitions.load(std::memory_order_relaxed),
+			stats_.contended_acquisitions.load(std::memory_order_relaxed),
+			time::Duration::from_nanos(
+				stats_.wait_nanos.load(std::memory_order_relaxed)
+			),
+		};
+	}
+
+private:
+	static constexpr uint32_t kUnlocked = 0;
+	static constexpr uint32_t kLocked = 1;
+	// Someone may be parked, so "unlock" has to wake it up.
+	static constexpr uint32_t kLockedWithWaiters = 2;
+	// Spins 1, 2, 4, ..., 2^(kSpinRounds - 1) times between attempts.
+	static constexpr size_t kSpinRounds = 7;
+
+	void lock_contended() {
+		for (size_t round = 0; round < kSpinRounds; ++round) {
+			for (size_t i = 0; i < ((size_t)1 << round); ++i) {
+				intrinsics::cpu_relax();
+			}
+			uint32_t c = state_.load(std::memory_order_relaxed);
+			if (c == kUnlocked && state_.compare_exchange_weak(c, kLocked,
+					std::memory_order_acquire, std::memory_order_relaxed)) {
+				return;
+			}
+			if (c == kLockedWithWaiters) {
+				// Others are parked already, spinning is unlikely to help.
+				break;
+			}
+		}
+		// We do not know whether we are the last waiter, so keep
+		// kLockedWithWaiters even after acquiring it.
+		while (state_.exchange(kLockedWithWaiters, std::memory_order_acquire) !=
+				kUnlocked) {
+			detail::futex_wait(state_, kLockedWithWaiters);
+		}
+	}
+
+	void count(bool contended, time::Duration wait) {
+		if constexpr (kStats) {
+			stats_.acquisitions.fetch_add(1, std::memory_order_relaxed);
+			if (contended) {
+				stats_.contended_acquisitions.fetch_add(
+					1, std::memory_order_relaxed
+				);
+				stats_.wait_nanos.fetch_add(
+					wait.as_nanos(), std::memory_order_relaxed
+				);
+			}
+		} else {
+			(void)contended;
+			(void)wait;
+		}
+	}
+
+	std::atomic<uint32_t> state_{kUnlocked};
+	std::conditional_t<
+		kStats, detail::MutexStatsCounters, detail::NoMutexStatsCounters
+	> stats_;
+};
+
+template <typename T>
+using AdaptiveMutex = Mutex<T, AdaptiveRawMutex<>>;
+// Same as AdaptiveMutex, but "raw().stats()" tells how contended it is.
+template <typename T>
+using ProfiledMutex = Mutex<T, AdaptiveRawMutex<true>>;
+
+} // namespace sync
+} // namespace rusty
+
+#endif // RUSTY_SYNC_ADAPTIVE_MUTEX_H_
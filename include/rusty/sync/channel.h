@@ -0,0 +1,520 @@
+#ifndef RUSTY_SYNC_CHANNEL_H_
+#define RUSTY_SYNC_CHANNEL_H_
+
+#include "rusty/option.h"
+#include "rusty/primitive.h"
+#include "rusty/result.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
+
+namespace rusty {
+namespace sync {
+
+// The receiving half has been dropped. Returns the unsent value.
+template <typename T>
+class SendError {
+public:
+	explicit SendError(T &&v) : v_(std::move(v)) {}
+	T into_inner() && { return std::move(v_); }
+private:
+	T v_;
+};
+
+enum class TrySendErrorKind {
+	Full,
+	Disconnected,
+};
+
+template <typename T>
+class TrySendError {
+public:
+	TrySendError(TrySendErrorKind kind, T &&v) : kind_(kind), v_(std::move(v)) {}
+	TrySendErrorKind kind() const { return kind_; }
+	T into_inner() && { return std::move(v_); }
+private:
+	TrySendErrorKind kind_;
+	T v_;
+};
+
+enum class TryRecvError {
+	Empty,
+	// The sending half has been dropped and the channel is empty.
+	Disconnected,
+};
+
+namespace detail {
+
+// Lets threads wait for a condition that other threads make true without
+// holding any lock, e.g., a change of an atomic variable.
+class Parker {
+public:
+	// Spins for a while before parking, since the condition is usually met
+	// soon when the other side is keeping up.
+	template <typename Pred>
+	void wait(Pred pred) {
+		for (size_t i = 0; i < kSpins; ++i) {
+			if (pred()) {
+				return;
+			}
+			std::this_thread::yield();
+		}
+		std::unique_lock<std::mutex> lock(mutex_);
+		waiters_.fetch_add(1, std::memory_order_relaxed);
+		// Pairs with the fence in "notify". Either "notify" sees the waiter,
+		// or "pred" sees the change made before "notify".
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		cv_.wait(lock, pred);
+		waiters_.fetch_sub(1, std::memory_order_relaxed);
+	}
+	// Must be called after making the condition true.
+	void notify() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiters_.load(std::memory_order_relaxed) != 0) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			cv_.notify_all();
+		}
+	}
+
+private:
+	static constexpr size_t kSpins = 16;
+
+	std::atomic<size_t> waiters_{0};
+	std::mutex mutex_;
+	std::condition_variable cv_;
+};
+
+} // namespace detail
+
+// Bounded lock-free single-producer single-consumer channel.
+namespace spsc {
+
+namespace detail {
+
+template <typename T>
+class Shared {
+public:
+	explicit Shared(size_t capacity)
+	  : capacity_(next_power_of_two(capacity)),
+		slots_(new Option<T>[capacity_]) {}
+
+	Result<std::monostate, TrySendError<T>> try_send(T &&v) {
+		if (!receiver_alive_.load(std::memory_order_relaxed)) {
+			return TrySendError<T>(
+				TrySendErrorKind::Disconnected, std::move(v)
+			);
+		}
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - cached_head_ == capacity_) {
+			cached_head_ = head_.load(std::memory_order_acquire);
+			if (tail - cached_head_ == capacity_) {
+				return TrySendError<T>(TrySendErrorKind::Full, std::move(v));
+			}
+		}
+		slots_[tail & (capacity_ - 1)] = std::move(v);
+		tail_.store(tail + 1, std::memory_order_release);
+		not_empty_.notify();
+		return std::monostate();
+	}
+	Result<T, TryRecvError> try_recv() {
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (head == cached_tail_) {
+			// Check the sender before the queue, so that values sent right
+			// before the sender is dropped are not missed.
+			bool alive = sender_alive_.load(std::memory_order_acquire);
+			cached_tail_ = tail_.load(std::memory_order_acquire);
+			if (head == cached_tail_) {
+				return alive ? TryRecvError::Empty : TryRecvError::Disconnected;
+			}
+		}
+		T ret = slots_[head & (capacity_ - 1)].take().unwrap_unchecked();
+		head_.store(head + 1, std::memory_order_release);
+		not_full_.notify();
+		return ret;
+	}
+
+	// Only called by the sender.
+	bool is_full() const {
+		return tail_.load(std::memory_order_relaxed) -
+			head_.load(std::memory_order_acquire) == capacity_;
+	}
+	// Only called by the receiver.
+	bool is_empty() const {
+		return head_.load(std::memory_order_relaxed) ==
+			tail_.load(std::memory_order_acquire);
+	}
+
+	void drop_sender() {
+		sender_alive_.store(false, std::memory_order_release);
+		not_empty_.notify();
+	}
+	void drop_receiver() {
+		receiver_alive_.store(false, std::memory_order_release);
+		not_full_.notify();
+	}
+	bool receiver_alive() const {
+		return receiver_alive_.load(std::memory_order_acquire);
+	}
+	bool sender_alive() const {
+		return sender_alive_.load(std::memory_order_acquire);
+	}
+
+	sync::detail::Parker not_empty_;
+	sync::detail::Parker not_full_;
+
+private:
+	const size_t capacity_;
+	std::unique_ptr<Option<T>[]> slots_;
+	// Owned by the receiver.
+	alignas(64) std::atomic<size_t> head_{0};
+	size_t cached_tail_ = 0;
+	// Owned by the sender.
+	alignas(64) std::atomic<size_t> tail_{0};
+	size_t cached_head_ = 0;
+	alignas(64) std::atomic<bool> sender_alive_{true};
+	std::atomic<bool> receiver_alive_{true};
+};
+
+} // namespace detail
+
+template <typename T>
+class Receiver;
+
+template <typename T>
+class Sender {
+public:
+	Sender(Sender &&) = default;
+	Sender &operator=(Sender &&rhs) {
+		// The old endpoint is dropped with "old".
+		Sender old(std::move(rhs));
+		std::swap(shared_, old.shared_);
+		return *this;
+	}
+	~Sender() {
+		if (shared_ != nullptr) {
+			shared_->drop_sender();
+		}
+	}
+
+	Result<std::monostate, TrySendError<T>> try_send(T v) {
+		return shared_->try_send(std::move(v));
+	}
+	// Blocks while the channel is full.
+	Result<std::monostate, SendError<T>> send(T v) {
+		for (;;) {
+			auto ret = shared_->try_send(std::move(v));
+			if (ret.is_ok()) {
+				return std::monostate();
+			}
+			auto err = std::move(ret).unwrap_err_unchecked();
+			v = std::move(err).into_inner();
+			if (err.kind() == TrySendErrorKind::Disconnected) {
+				return SendError<T>(std::move(v));
+			}
+			shared_->not_full_.wait([this] {
+				return !shared_->is_full() || !shared_->receiver_alive();
+			});
+		}
+	}
+
+private:
+	explicit Sender(
+		std::shared_ptr<detail::Shared<T>> shared
+	) : shared_(std::move(shared)) {}
+	std::shared_ptr<detail::Shared<T>> shared_;
+	template <typename U>
+	friend std::pair<Sender<U>, Receiver<U>> channel(size_t);
+};
+
+template <typename T>
+class Receiver {
+public:
+	Receiver(Receiver &&) = default;
+	Receiver &operator=(Receiver &&rhs) {
+		// The old endpoint is dropped with "old".
+		Receiver old(std::move(rhs));
+		std::swap(shared_, old.shared_);
+		return *this;
+	}
+	~Receiver() {
+		if (shared_ != nullptr) {
+			shared_->drop_receiver();
+		}
+	}
+
+	Result<T, TryRecvError> try_recv() {
+		return shared_->try_recv();
+	}
+	// Blocks while the channel is empty. Returns None if the channel is empty
+	// and the sender has been dropped.
+	Option<T> recv() {
+		for (;;) {
+			auto ret = shared_->try_recv();
+			if (ret.is_ok()) {
+				return std::move(ret).unwrap_unchecked();
+			}
+			if (std::move(ret).unwrap_err_unchecked() ==
+					TryRecvError::Disconnected) {
+				return None;
+			}
+			shared_->not_empty_.wait([this] {
+				return !shared_->is_empty() || !shared_->sender_alive();
+			});
+		}
+	}
+
+private:
+	explicit Receiver(
+		std::shared_ptr<detail::Shared<T>> shared
+	) : shared_(std::move(shared)) {}
+	std::shared_ptr<detail::Shared<T>> shared_;
+	template <typename U>
+	friend std::pair<Sender<U>, Receiver<U>> channel(size_t);
+};
+
+// "capacity" is rounded up to a power of two.
+template <typename T>
+std::pair<Sender<T>, Receiver<T>> channel(size_t capacity) {
+	auto shared = std::make_shared<detail::Shared<T>>(capacity);
+	return {Sender<T>(shared), Receiver<T>(shared)};
+}
+
+} // namespace spsc
+
+// Bounded lock-free multi-producer multi-consumer channel, based on
+// Dmitry Vyukov's bounded MPMC queue. Sender and Receiver can be cloned.
+namespace mpmc {
+
+namespace detail {
+
+template <typename T>
+class Shared {
+public:
+	explicit Shared(size_t capacity)
+	  : capacity_(next_power_of_two(capacity)),
+		cells_(new Cell[capacity_]) {
+		for (size_t i = 0; i < capacity_; ++i) {
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// A cell is ready to be written at position "pos" when its sequence
+	// number is "pos", and ready to be read when it is "pos + 1".
+	Result<std::monostate, TrySendError<T>> try_send(T &&v) {
+		if (receivers_.load(std::memory_order_relaxed) == 0) {
+			return TrySendError<T>(
+				TrySendErrorKind::Disconnected, std::move(v)
+			);
+		}
+		size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+		Cell *cell;
+		for (;;) {
+			cell = &cells_[pos & (capacity_ - 1)];
+			size_t seq = cell->seq.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (enqueue_pos_.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return TrySendError<T>(TrySendErrorKind::Full, std::move(v));
+			} else {
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = std::move(v);
+		cell->seq.store(pos + 1, std::memory_order_release);
+		not_empty_.notify();
+		return std::monostate();
+	}
+	Result<T, TryRecvError> try_recv() {
+		// Check the senders before the queue, so that values sent right
+		// before the last sender is dropped are not missed.
+		bool alive = senders_.load(std::memory_order_acquire) != 0;
+		size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+		Cell *cell;
+		for (;;) {
+			cell = &cells_[pos & (capacity_ - 1)];
+			size_t seq = cell->seq.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+			if (diff == 0) {
+				if (dequeue_pos_.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return alive ? TryRecvError::Empty : TryRecvError::Disconnected;
+			} else {
+				pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+		T ret = cell->value.take().unwrap_unchecked();
+		cell->seq.store(pos + capacity_, std::memory_order_release);
+		not_full_.notify();
+		return ret;
+	}
+
+	// Approximate, only used to decide whether to keep waiting.
+	bool is_full() const {
+		size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+		const Cell &cell = cells_[pos & (capacity_ - 1)];
+		return (intptr_t)cell.seq.load(std::memory_order_acquire) -
+			(intptr_t)pos < 0;
+	}
+	bool is_empty() const {
+		size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+		const Cell &cell = cells_[pos & (capacity_ - 1)];
+		return (intptr_t)cell.seq.load(std::memory_order_acquire) -
+			(intptr_t)(pos + 1) < 0;
+	}
+
+	std::atomic<size_t> senders_{1};
+	std::atomic<size_t> receivers_{1};
+	sync::detail::Parker not_empty_;
+	sync::detail::Parker not_full_;
+
+private:
+	class Cell {
+	public:
+		std::atomic<size_t> seq;
+		Option<T> value;
+	};
+
+	const size_t capacity_;
+	std::unique_ptr<Cell[]> cells_;
+	alignas(64) std::atomic<size_t> enqueue_pos_{0};
+	alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+} // namespace detail
+
+template <typename T>
+class Receiver;
+
+template <typename T>
+class Sender {
+public:
+	Sender(Sender &&) = default;
+	Sender &operator=(Sender &&rhs) {
+		// The old endpoint is dropped with "old".
+		Sender old(std::move(rhs));
+		std::swap(shared_, old.shared_);
+		return *this;
+	}
+	~Sender() {
+		if (shared_ == nullptr) {
+			return;
+		}
+		if (shared_->senders_.fetch_sub(1, std::memory_order_release) == 1) {
+			shared_->not_empty_.notify();
+		}
+	}
+	Sender clone() const {
+		shared_->senders_.fetch_add(1, std::memory_order_relaxed);
+		return Sender(shared_);
+	}
+
+	Result<std::monostate, TrySendError<T>> try_send(T v) {
+		return shared_->try_send(std::move(v));
+	}
+	// Blocks while the channel is full.
+	Result<std::monostate, SendError<T>> send(T v) {
+		for (;;) {
+			auto ret = shared_->try_send(std::move(v));
+			if (ret.is_ok()) {
+				return std::monostate();
+			}
+			auto err = std::move(ret).unwrap_err_unchecked();
+			v = std::move(err).into_inner();
+			if (err.kind() == TrySendErrorKind::Disconnected) {
+				return SendError<T>(std::move(v));
+			}
+			shared_->not_full_.wait([this] {
+				return !shared_->is_full() ||
+					shared_->receivers_.load(std::memory_order_relaxed) == 0;
+			});
+		}
+	}
+
+private:
+	explicit Sender(
+		std::shared_ptr<detail::Shared<T>> shared
+	) : shared_(std::move(shared)) {}
+	std::shared_ptr<detail::Shared<T>> shared_;
+	template <typename U>
+	friend std::pair<Sender<U>, Receiver<U>> channel(size_t);
+};
+
+template <typename T>
+class Receiver {
+public:
+	Receiver(Receiver &&) = default;
+	Receiver &operator=(Receiver &&rhs) {
+		// The old endpoint is dropped with "old".
+		Receiver old(std::move(rhs));
+		std::swap(shared_, old.shared_);
+		return *this;
+	}
+	~Receiver() {
+		if (shared_ == nullptr) {
+			return;
+		}
+		if (shared_->receivers_.fetch_sub(1, std::memory_order_release) == 1) {
+			shared_->not_full_.notify();
+		}
+	}
+	Receiver clone() const {
+		shared_->receivers_.fetch_add(1, std::memory_order_relaxed);
+		return Receiver(shared_);
+	}
+
+	Result<T, TryRecvError> try_recv() {
+		return shared_->try_recv();
+	}
+	// Blocks while the channel is empty. Returns None if the channel is empty
+	// and all senders have been dropped.
+	Option<T> recv() {
+		for (;;) {
+			auto ret = shared_->try_recv();
+			if (ret.is_ok()) {
+				return std::move(ret).unwrap_unchecked();
+			}
+			if (std::move(ret).unwrap_err_unchecked() ==
+					TryRecvError::Disconnected) {
+				return None;
+			}
+			shared_->not_empty_.wait([this] {
+				return !shared_->is_empty() ||
+					shared_->senders_.load(std::memory_order_acquire) == 0;
+			});
+		}
+	}
+
+private:
+	explicit Receiver(
+		std::shared_ptr<detail::Shared<T>> shared
+	) : shared_(std::move(shared)) {}
+	std::shared_ptr<detail::Shared<T>> shared_;
+	template <typename U>
+	friend std::pair<Sender<U>, Receiver<U>> channel(size_t);
+};
+
+// "capacity" is rounded up to a power of two.
+template <typename T>
+std::pair<Sender<T>, Receiver<T>> channel(size_t capacity) {
+	auto shared = std::make_shared<detail::Shared<T>>(capacity);
+	return {Sender<T>(shared), Receiver<T>(shared)};
+}
+
+} // namespace mpmc
+
+} // namespace sync
+} // namespace rusty
+
+#endif // RUSTY_SYNC_CHANNEL_H_
@@ -0,0 +1,183 @@
+#ifndef RUSTY_TIME_HISTOGRAM_H_
+#define RUSTY_TIME_HISTOGRAM_H_
+
+#include "rusty/intrinsics.h"
+#include "rusty/time.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace rusty {
+namespace time {
+
+namespace detail {
+
+// Log-linear buckets: values below 2 * kSubBuckets get a bucket each, and every
+// larger power-of-two range [2^k, 2^(k+1)) is split into kSubBuckets equal
+// buckets, so the relative error is below 1 / kSubBuckets.
+constexpr size_t kSubBucketBits = 5;
+constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+constexpr size_t kHistogramBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+inline size_t histogram_bucket(uint64_t v) {
+	if (v < 2 * kSubBuckets) {
+		return v;
+	}
+	size_t shift = 63 - __builtin_clzll(v) - kSubBucketBits;
+	return shift * kSubBuckets + (v >> shift);
+}
+// The largest value that falls into "bucket".
+inline uint64_t histogram_bucket_max(size_t bucket) {
+	if (bucket < 2 * kSubBuckets) {
+		return bucket;
+	}
+	size_t shift = bucket / kSubBuckets - 1;
+	uint64_t top = bucket % kSubBuckets + kSubBuckets;
+	return (top << shift) + (((uint64_t)1 << shift) - 1);
+}
+
+} // namespace detail
+
+// The content of a Histogram at some point. Snapshots of histograms can be
+// merged, e.g., to aggregate across histograms of different processes.
+class HistogramSnapshot {
+public:
+	HistogramSnapshot() : counts_{} {}
+
+	uint64_t count() const { return count_; }
+	Duration sum() const { return Duration::from_nanos(sum_); }
+	Duration max() const { return Duration::from_nanos(max_); }
+	Duration mean() const {
+		return Duration::from_nanos(count_ == 0 ? 0 : sum_ / count_);
+	}
+	// The smallest recorded value that at least "q" of all values are not
+	// greater than, up to the bucket precision. "q" is in [0, 1].
+	Duration quantile(double q) const {
+		if (count_ == 0) {
+			return Duration();
+		}
+		uint64_t rank = std::max<uint64_t>(1, (uint64_t)(q * count_ + 0.5));
+		rank = std::min(rank, count_);
+		uint64_t seen = 0;
+		for (size_t i = 0; i < counts_.size(); ++i) {
+			seen += counts_[i];
+			if (seen >= rank) {
+				return Duration::from_nanos(
+					std::min(detail::histogram_bucket_max(i), max_)
+				);
+			}
+		}
+		return max();
+	}
+	Duration p50() const { return quantile(0.5); }
+	Duration p99() const { return quantile(0.99); }
+	Duration p999() const { return quantile(0.999); }
+
+	void merge(const HistogramSnapshot &rhs) {
+		for (size_t i = 0; i < counts_.size(); ++i) {
+			counts_[i] += rhs.counts_[i];
+		}
+		count_ += rhs.count_;
+		sum_ += rhs.sum_;
+		max_ = std::max(max_, rhs.max_);
+	}
+
+private:
+	std::array<uint64_t, detail::kHistogramBuckets> counts_;
+	uint64_t count_ = 0;
+	uint64_t sum_ = 0;
+	uint64_t max_ = 0;
+	friend class Histogram;
+};
+
+class Histogram;
+
+// Records the time from its creation to its destruction into a Histogram.
+class HistogramTimer {
+public:
+	HistogramTimer(const HistogramTimer &) = delete;
+	HistogramTimer &operator=(const HistogramTimer &) = delete;
+	~HistogramTimer();
+
+private:
+	explicit HistogramTimer(Histogram &histogram)
+	  : histogram_(histogram), start_(Instant::now()) {}
+	Histogram &histogram_;
+	Instant start_;
+	friend class Histogram;
+};
+
+// A fixed-memory histogram of durations with about 3% relative precision.
+// Recording is lock-free: each thread records into its own shard with relaxed
+// atomics, and "snapshot" adds up the shards.
+class Histogram {
+public:
+	explicit Histogram(
+		size_t shards = std::thread::hardware_concurrency()
+	) : mask_(next_power_of_two(std::max<size_t>(shards, 1)) - 1),
+		shards_(new intrinsics::CachePadded<Shard>[mask_ + 1]) {}
+
+	void record(Duration d) {
+		record_nanos(d.as_nanos());
+	}
+	void record_nanos(uint64_t nanos) {
+		Shard &shard = *shards_[intrinsics::detail::thread_shard_id() & mask_];
+		shard.counts[detail::histogram_bucket(nanos)].fetch_add(
+			1, std::memory_order_relaxed
+		);
+		shard.sum.fetch_add(nanos, std::memory_order_relaxed);
+		intrinsics::atomic_max_relaxed(shard.max, nanos);
+	}
+	// Records the lifetime of the returned guard.
+	HistogramTimer start_timer() {
+		return HistogramTimer(*this);
+	}
+
+	// Concurrent records may or may not be included.
+	HistogramSnapshot snapshot() const {
+		HistogramSnapshot ret;
+		for (size_t s = 0; s <= mask_; ++s) {
+			const Shard &shard = *shards_[s];
+			for (size_t i = 0; i < detail::kHistogramBuckets; ++i) {
+				uint64_t c = shard.counts[i].load(std::memory_order_relaxed);
+				ret.counts_[i] += c;
+				ret.count_ += c;
+			}
+			ret.sum_ += shard.sum.load(std::memory_order_relaxed);
+			ret.max_ = std::max(
+				ret.max_, shard.max.load(std::memory_order_relaxed)
+			);
+		}
+		return ret;
+	}
+
+private:
+	class Shard {
+	public:
+		Shard() {
+			for (auto &c : counts) {
+				c.store(0, std::memory_order_relaxed);
+			}
+		}
+		std::array<std::atomic<uint64_t>, detail::kHistogramBuckets> counts;
+		std::atomic<uint64_t> sum{0};
+		std::atomic<uint64_t> max{0};
+	};
+
+	const size_t mask_;
+	std::unique_ptr<intrinsics::CachePadded<Shard>[]> shards_;
+};
+
+inline HistogramTimer::~HistogramTimer() {
+	histogram_.record(start_.elapsed());
+}
+
+} // namespace time
+} // namespace rusty
+
+#endif // RUSTY_TIME_HISTOGRAM_H_
@@ -0,0 +1,105 @@
+#include "rusty/collections/indexed_min_heap.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+TEST_F(Test, IndexedMinHeapSimple) {
+	rusty::IndexedMinHeap<int> heap;
+	ASSERT_TRUE(heap.is_empty());
+	ASSERT_TRUE(heap.peek() == nullptr);
+	ASSERT_TRUE(heap.pop().is_none());
+
+	auto h3 = heap.push(3);
+	auto h1 = heap.push(1);
+	auto h2 = heap.push(2);
+	ASSERT_EQ(heap.len(), 3);
+	ASSERT_EQ(*heap.peek(), 1);
+	ASSERT_TRUE(heap.peek_handle().unwrap() == h1);
+
+	heap.decrease_key(h3, 0);
+	ASSERT_EQ(*heap.peek(), 0);
+	ASSERT_EQ(*heap.get(h3), 0);
+	heap.update(h3, 5);
+	ASSERT_EQ(*heap.peek(), 1);
+
+	ASSERT_EQ(heap.remove(h1).unwrap(), 1);
+	ASSERT_FALSE(heap.contains(h1));
+	ASSERT_TRUE(heap.get(h1) == nullptr);
+	ASSERT_TRUE(heap.remove(h1).is_none());
+
+	// The slot of h1 is reused, but h1 must stay stale.
+	auto h4 = heap.push(4);
+	ASSERT_TRUE(h4 != h1);
+	ASSERT_FALSE(heap.contains(h1));
+	ASSERT_EQ(*heap.get(h4), 4);
+
+	ASSERT_EQ(heap.pop().unwrap(), 2);
+	ASSERT_FALSE(heap.contains(h2));
+	ASSERT_EQ(heap.pop().unwrap(), 4);
+	ASSERT_EQ(heap.pop().unwrap(), 5);
+	ASSERT_TRUE(heap.is_empty());
+}
+
+template <size_t Arity>
+static void IndexedMinHeapRandom() {
+	using Heap = rusty::IndexedMinHeap<int, std::less<int>, Arity>;
+	std::mt19937 rng(233);
+	Heap heap;
+	std::multiset<int> expected;
+	std::vector<typename Heap::Handle> handles;
+	for (size_t i = 0; i < 10000; ++i) {
+		int x = rng() % 1000;
+		switch (rng() % 5) {
+		case 0:
+		case 1:
+			handles.push_back(heap.push(x));
+			expected.insert(x);
+			break;
+		case 2:
+			if (!expected.empty()) {
+				ASSERT_EQ(heap.pop().unwrap(), *expected.begin());
+				expected.erase(expected.begin());
+			}
+			break;
+		case 3:
+		case 4: {
+			if (handles.empty()) {
+				break;
+			}
+			size_t k = rng() % handles.size();
+			auto h = handles[k];
+			const int *v = heap.get(h);
+			if (v == nullptr) {
+				ASSERT_TRUE(heap.remove(h).is_none());
+				handles[k] = handles.back();
+				handles.pop_back();
+				break;
+			}
+			int old = *v;
+			expected.erase(expected.find(old));
+			if (rng() % 2) {
+				ASSERT_EQ(heap.remove(h).unwrap(), old);
+			} else {
+				if (x <= old) {
+					heap.decrease_key(h, x);
+				} else {
+					heap.update(h, x);
+				}
+				expected.insert(x);
+			}
+			break;
+		}
+		}
+		ASSERT_EQ(heap.len(), expected.size());
+		if (!expected.empty()) {
+			ASSERT_EQ(*heap.peek(), *expected.begin());
+		}
+	}
+}
+
+TEST_F(Test, IndexedMinHeapRandom) {
+	IndexedMinHeapRandom<2>();
+	IndexedMinHeapRandom<4>();
+}
@@ -1,8 +1,10 @@
 #include "rusty/collections/min_heap.h"
 #include "test.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <queue>
+#include <random>
 
 namespace {
 void pop_all(rusty::MinHeap<int> &heap, std::priority_queue<int, std::vector<int>, std::greater<int>> &q) {
@@ -17,6 +19,35 @@ void pop_all(rusty::MinHeap<int> &heap, std::priority_queue<int, std::vector<int
 	}
 	ASSERT_TRUE(q.empty());
 }
+
+template <size_t Arity>
+void check_random() {
+	std::mt19937 rng(233);
+	for (size_t n = 0; n < 100; ++n) {
+		std::vector<std::string> data;
+		for (size_t i = 0; i < n; ++i) {
+			data.push_back(std::to_string(rng() % 50));
+		}
+		std::priority_queue<
+			std::string, std::vector<std::string>, std::greater<std::string>
+		> q(data.begin(), data.end());
+		auto heap = rusty::MakeMinHeap<Arity>(data);
+		while (!q.empty()) {
+			if (rng() % 2) {
+				auto peeked = heap.peek_mut().unwrap();
+				ASSERT_EQ(*peeked, q.top());
+				auto x = std::to_string(rng() % 50);
+				*peeked = x;
+				q.pop();
+				q.push(x);
+			} else {
+				ASSERT_EQ(heap.pop().unwrap(), q.top());
+				q.pop();
+			}
+		}
+		ASSERT_TRUE(heap.is_empty());
+	}
+}
 }
 
 TEST_F(Test, MinHeapSimple) {
@@ -43,3 +74,87 @@ TEST_F(Test, MinHeapSimple) {
 	}
 	ASSERT_NO_FATAL_FAILURE(pop_all(heap, q));
 }
+
+TEST_F(Test, MinHeapRandom) {
+	ASSERT_NO_FATAL_FAILURE(check_random<2>());
+	ASSERT_NO_FATAL_FAILURE(check_random<3>());
+	ASSERT_NO_FATAL_FAILURE(check_random<4>());
+	ASSERT_NO_FATAL_FAILURE(check_random<8>());
+}
+
+TEST_F(Test, MinHeapPush) {
+	std::mt19937 rng(233);
+	rusty::MinHeap<int> heap;
+	heap.reserve(100);
+	std::priority_queue<int, std::vector<int>, std::greater<int>> q;
+	for (size_t i = 0; i < 1000; ++i) {
+		int x = rng() % 100;
+		if (rng() % 3) {
+			if (rng() % 2) {
+				heap.push(x);
+			} else {
+				heap.emplace(x);
+			}
+			q.push(x);
+		} else if (!q.empty()) {
+			ASSERT_EQ(heap.pop().unwrap(), q.top());
+			q.pop();
+		}
+		ASSERT_EQ(heap.len(), q.size());
+	}
+	ASSERT_NO_FATAL_FAILURE(pop_all(heap, q));
+}
+
+TEST_F(Test, MinHeapExtend) {
+	std::mt19937 rng(233);
+	// Small batches are sifted up, while large batches trigger a rebuild.
+	for (size_t batch : {0, 1, 3, 100, 3000}) {
+		std::vector<int> data;
+		for (size_t i = 0; i < 3000; ++i) {
+			data.push_back(rng() % 1000);
+		}
+		std::priority_queue<int, std::vector<int>, std::greater<int>> q(
+			data.begin(), data.end()
+		);
+		auto heap = rusty::MakeMinHeap(std::move(data));
+		std::vector<int> more;
+		for (size_t i = 0; i < batch; ++i) {
+			more.push_back(rng() % 1000);
+			q.push(more.back());
+		}
+		if (batch % 2) {
+			heap.extend(more);
+		} else {
+			heap.extend(std::move(more));
+		}
+		ASSERT_NO_FATAL_FAILURE(pop_all(heap, q));
+	}
+
+	std::vector<std::unique_ptr<int>> v;
+	v.push_back(std::make_unique<int>(2));
+	v.push_back(std::make_unique<int>(1));
+	auto cmp = [](const auto &a, const auto &b) { return *a < *b; };
+	auto heap = rusty::MakeMinHeap(
+		std::vector<std::unique_ptr<int>>(), cmp
+	);
+	heap.extend(std::move(v));
+	ASSERT_EQ(*heap.pop().unwrap(), 1);
+	ASSERT_EQ(*heap.pop().unwrap(), 2);
+}
+
+TEST_F(Test, MinHeapIntoVec) {
+	std::mt19937 rng(233);
+	for (size_t n = 0; n < 50; ++n) {
+		std::vector<int> data;
+		for (size_t i = 0; i < n; ++i) {
+			data.push_back(rng() % 20);
+		}
+		auto sorted = data;
+		std::sort(sorted.begin(), sorted.end());
+		ASSERT_EQ(rusty::MakeMinHeap(data).into_sorted_vec(), sorted);
+		ASSERT_EQ(rusty::MakeMinHeap<4>(data).into_sorted_vec(), sorted);
+		auto v = rusty::MakeMinHeap(data).into_vec();
+		std::sort(v.begin(), v.end());
+		ASSERT_EQ(v, sorted);
+	}
+}
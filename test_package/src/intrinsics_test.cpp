@@ -0,0 +1,82 @@
+#include "rusty/intrinsics.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace rusty::intrinsics;
+
+TEST_F(Test, AtomicMinMax) {
+	std::atomic<int> x(5);
+	ASSERT_EQ(atomic_max(x, 3), 5);
+	ASSERT_EQ(x.load(), 5);
+	ASSERT_EQ(atomic_max(x, 7, std::memory_order_release), 5);
+	ASSERT_EQ(x.load(), 7);
+	ASSERT_EQ(atomic_max_relaxed(x, 8), 7);
+	ASSERT_EQ(atomic_min(x, 9), 8);
+	ASSERT_EQ(atomic_min_relaxed(x, 2), 8);
+	ASSERT_EQ(x.load(), 2);
+
+	std::atomic<uint64_t> high(0);
+	std::vector<std::thread> threads;
+	for (uint64_t i = 0; i < 4; ++i) {
+		threads.emplace_back([&high, i] {
+			for (uint64_t j = i; j < 10000; j += 4) {
+				atomic_max_relaxed(high, j);
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(high.load(), 9999);
+}
+
+TEST_F(Test, FetchUpdate) {
+	std::atomic<int> x(1);
+	auto double_below_10 = [](int v) -> rusty::Option<int> {
+		if (v >= 10) {
+			return rusty::None;
+		}
+		return v * 2;
+	};
+	for (int expected : {1, 2, 4, 8}) {
+		auto ret = fetch_update(x, std::memory_order_acq_rel,
+			std::memory_order_acquire, double_below_10);
+		ASSERT_EQ(std::move(ret).unwrap(), expected);
+	}
+	ASSERT_EQ(x.load(), 16);
+	ASSERT_TRUE(fetch_update(x, std::memory_order_acq_rel,
+		std::memory_order_acquire, double_below_10).is_none());
+	ASSERT_EQ(x.load(), 16);
+}
+
+TEST_F(Test, CachePadded) {
+	CachePadded<int> a[2] = {1, 2};
+	ASSERT_EQ(alignof(CachePadded<int>), kCacheLineSize);
+	ASSERT_GE((char *)&*a[1] - (char *)&*a[0], kCacheLineSize);
+	*a[0] += 1;
+	ASSERT_EQ(*a[0], 2);
+	CachePadded<std::vector<int>> v(3, 7);
+	ASSERT_EQ(v->size(), 3);
+	auto copy = v;
+	ASSERT_EQ((*copy)[2], 7);
+}
+
+TEST_F(Test, ShardedCounter) {
+	ShardedCounter counter(4);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; ++i) {
+		threads.emplace_back([&counter] {
+			for (int j = 0; j < 10000; ++j) {
+				counter.add(1);
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(counter.sum(), 80000);
+	counter.add(-1);
+	ASSERT_EQ(counter.sum(), 79999);
+}
@@ -0,0 +1,99 @@
+#include "rusty/io/mmap.h"
+#include "rusty/iter/merging_iterator.h"
+#include "test.h"
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace {
+// Creates a temporary file with "content", which is removed on destruction.
+class TempFile {
+public:
+	explicit TempFile(const std::string &content) {
+		path_ = "/tmp/rusty-mmap-test-XXXXXX";
+		int fd = mkstemp(path_.data());
+		EXPECT_NE(fd, -1);
+		EXPECT_EQ(
+			write(fd, content.data(), content.size()),
+			static_cast<ssize_t>(content.size())
+		);
+		close(fd);
+	}
+	~TempFile() {
+		unlink(path_.c_str());
+	}
+	const std::string &path() const {
+		return path_;
+	}
+
+private:
+	std::string path_;
+};
+
+template <typename T>
+std::string to_bytes(const std::vector<T> &v) {
+	return std::string(
+		reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T)
+	);
+}
+
+std::string frame(const std::string &s) {
+	uint32_t len = s.size();
+	return std::string(reinterpret_cast<const char *>(&len), sizeof(len)) + s;
+}
+} // namespace
+
+TEST_F(Test, MmapRecords) {
+	TempFile a(to_bytes(std::vector<uint64_t>{1, 4, 9}));
+	TempFile b(to_bytes(std::vector<uint64_t>{2, 3, 10}));
+	auto ma = rusty::io::Mmap::open(a.path()).unwrap();
+	auto mb = rusty::io::Mmap::open(b.path()).unwrap();
+	ASSERT_EQ(ma.len(), 3 * sizeof(uint64_t));
+
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const uint64_t>>>> iters;
+	for (const auto *m : {&ma, &mb}) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(m->records<uint64_t>())
+		));
+	}
+	std::vector<rusty::Ref<const uint64_t>> v;
+	rusty::collect_into(rusty::NewMergingIterator(std::move(iters)), v);
+	std::vector<uint64_t> expected{1, 2, 3, 4, 9, 10};
+	ASSERT_EQ(v.size(), expected.size());
+	for (size_t i = 0; i < v.size(); ++i) {
+		ASSERT_EQ(v[i].deref(), expected[i]);
+		// Zero-copy
+		auto p = reinterpret_cast<const char *>(&v[i].deref());
+		ASSERT_TRUE(
+			(ma.data() <= p && p < ma.data() + ma.len()) ||
+			(mb.data() <= p && p < mb.data() + mb.len())
+		);
+	}
+}
+
+TEST_F(Test, MmapFrames) {
+	TempFile file(frame("ab") + frame("") + frame("cde") + "\x05");
+	auto m = rusty::io::Mmap::open(file.path()).unwrap();
+	auto frames = m.frames();
+	ASSERT_EQ(frames.next().unwrap(), "ab");
+	ASSERT_EQ(frames.next().unwrap(), "");
+	ASSERT_EQ(frames.next().unwrap(), "cde");
+	ASSERT_TRUE(frames.next().is_none());
+	// The truncated frame
+	ASSERT_EQ(frames.remainder(), "\x05");
+}
+
+TEST_F(Test, MmapEmptyAndError) {
+	TempFile empty("");
+	auto m = rusty::io::Mmap::open(empty.path()).unwrap();
+	ASSERT_EQ(m.len(), 0);
+	ASSERT_TRUE(m.records<int>().next().is_none());
+	ASSERT_TRUE(m.frames().next().is_none());
+
+	auto ret = rusty::io::Mmap::open("/nonexistent-dir/file");
+	ASSERT_TRUE(ret.is_err());
+	auto err = std::move(ret).unwrap_err();
+	ASSERT_EQ(err.kind(), rusty::io::ErrorKind::NotFound);
+	ASSERT_EQ(std::move(err.raw_os_error()).unwrap(), ENOENT);
+}
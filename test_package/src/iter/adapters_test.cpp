@@ -0,0 +1,216 @@
+#include "rusty/iter/adapters.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+
+namespace {
+
+template <typename I>
+std::vector<typename I::value_type> collect(I &&iter) {
+	std::vector<typename I::value_type> v;
+	rusty::collect_into(std::move(iter), v);
+	return v;
+}
+
+std::vector<int> iota(int n) {
+	std::vector<int> v(n);
+	std::iota(v.begin(), v.end(), 0);
+	return v;
+}
+
+} // namespace
+
+TEST_F(Test, AdaptersMapFilter) {
+	auto a = iota(10);
+	auto v = collect(rusty::MakeMap(
+		rusty::MakeFilter(
+			rusty::slice::MakeIter(a),
+			[](rusty::Ref<const int> x) { return x.deref() % 3 == 0; }
+		),
+		[](rusty::Ref<const int> x) { return x.deref() * 10; }
+	));
+	ASSERT_EQ(v, (std::vector<int>{0, 30, 60, 90}));
+
+	auto strs = collect(rusty::MakeFilterMap(
+		rusty::slice::MakeIter(a),
+		[](rusty::Ref<const int> x) -> rusty::Option<std::string> {
+			if (x.deref() % 4 != 1) {
+				return rusty::None;
+			}
+			return std::to_string(x.deref());
+		}
+	));
+	ASSERT_EQ(strs, (std::vector<std::string>{"1", "5", "9"}));
+}
+
+TEST_F(Test, AdaptersTakeSkip) {
+	auto a = iota(10);
+	auto v = collect(rusty::MakeMap(
+		rusty::MakeTake(rusty::MakeSkip(rusty::slice::MakeIter(a), 3), 4),
+		[](rusty::Ref<const int> x) { return x.deref(); }
+	));
+	ASSERT_EQ(v, (std::vector<int>{3, 4, 5, 6}));
+
+	// Batches are forwarded and truncated.
+	auto take = rusty::MakeTake(rusty::slice::MakeIter(a), 5);
+	std::vector<rusty::Ref<const int>> batch;
+	ASSERT_EQ(rusty::detail::next_batch(take, batch, 3), 3);
+	ASSERT_EQ(rusty::detail::next_batch(take, batch, 3), 2);
+	ASSERT_EQ(rusty::detail::next_batch(take, batch, 3), 0);
+	ASSERT_EQ(batch.back().deref(), 4);
+
+	ASSERT_TRUE(
+		rusty::MakeSkip(rusty::slice::MakeIter(a), 11).next().is_none()
+	);
+	ASSERT_TRUE(
+		rusty::MakeTake(rusty::slice::MakeIter(a), 0).next().is_none()
+	);
+}
+
+TEST_F(Test, AdaptersChainZipEnumerate) {
+	auto a = iota(3);
+	auto b = iota(5);
+	auto chained = collect(rusty::MakeChain(
+		rusty::slice::MakeIter(a),
+		// Trait objects can be mixed with concrete iterators.
+		rusty::NewIterator(rusty::slice::MakeIter(b))
+	));
+	ASSERT_EQ(chained.size(), 8);
+	ASSERT_EQ(chained[2].deref(), 2);
+	ASSERT_EQ(chained[3].deref(), 0);
+
+	auto zipped = collect(rusty::MakeZip(
+		rusty::MakeEnumerate(rusty::slice::MakeIter(a)),
+		rusty::MakeSkip(rusty::slice::MakeIter(b), 1)
+	));
+	ASSERT_EQ(zipped.size(), 3);
+	for (size_t i = 0; i < zipped.size(); ++i) {
+		ASSERT_EQ(zipped[i].first.first, i);
+		ASSERT_EQ(zipped[i].first.second.deref(), (int)i);
+		ASSERT_EQ(zipped[i].second.deref(), (int)i + 1);
+	}
+}
+
+TEST_F(Test, AdaptersTakeWhileFold) {
+	std::vector<int> a{1, 2, 5, 1, 2};
+	auto iter = rusty::MakeTakeWhile(
+		rusty::slice::MakeIter(a),
+		[](rusty::Ref<const int> x) { return x.deref() < 3; }
+	);
+	ASSERT_EQ(iter.next().unwrap().deref(), 1);
+	ASSERT_EQ(iter.next().unwrap().deref(), 2);
+	ASSERT_TRUE(iter.next().is_none());
+	ASSERT_TRUE(iter.next().is_none());
+
+	int sum = rusty::fold(
+		rusty::slice::MakeIter(a), 0,
+		[](int acc, rusty::Ref<const int> x) { return acc + x.deref(); }
+	);
+	ASSERT_EQ(sum, 11);
+
+	std::vector<int> seen;
+	rusty::for_each(
+		rusty::MakeSkip(rusty::slice::MakeIter(a), 3),
+		[&seen](rusty::Ref<const int> x) { seen.push_back(x.deref()); }
+	);
+	ASSERT_EQ(seen, (std::vector<int>{1, 2}));
+
+	// fold borrows an lvalue iterator.
+	auto it = rusty::slice::MakeIter(a);
+	it.next();
+	ASSERT_EQ(rusty::fold(it, std::string(),
+		[](std::string acc, rusty::Ref<const int> x) {
+			return acc + std::to_string(x.deref());
+		}), "2512");
+	ASSERT_TRUE(it.next().is_none());
+}
+
+TEST_F(Test, AdaptersSizeHint) {
+	using rusty::detail::size_hint;
+	auto a = iota(10);
+	auto is_even = [](rusty::Ref<const int> x) { return x.deref() % 2 == 0; };
+	auto hint = size_hint(rusty::MakeFilter(rusty::slice::MakeIter(a), is_even));
+	ASSERT_EQ(hint.first, 0);
+	ASSERT_EQ(std::move(hint.second).unwrap(), 10);
+
+	hint = size_hint(rusty::MakeTake(rusty::slice::MakeIter(a), 4));
+	ASSERT_EQ(hint.first, 4);
+	ASSERT_EQ(std::move(hint.second).unwrap(), 4);
+	hint = size_hint(rusty::MakeSkip(rusty::slice::MakeIter(a), 4));
+	ASSERT_EQ(hint.first, 6);
+	ASSERT_EQ(std::move(hint.second).unwrap(), 6);
+
+	auto zip = rusty::MakeZip(
+		rusty::MakeEnumerate(rusty::slice::MakeIter(a)),
+		rusty::MakeChain(
+			rusty::MakeTake(rusty::slice::MakeIter(a), 2),
+			rusty::MakeFilter(rusty::slice::MakeIter(a), is_even)
+		)
+	);
+	hint = size_hint(zip);
+	ASSERT_EQ(hint.first, 2);
+	ASSERT_EQ(std::move(hint.second).unwrap(), 10);
+
+	auto take_while = rusty::MakeTakeWhile(rusty::slice::MakeIter(a), is_even);
+	take_while.next();
+	take_while.next();
+	hint = size_hint(take_while);
+	ASSERT_EQ(hint.first, 0);
+	ASSERT_EQ(std::move(hint.second).unwrap(), 0);
+}
+
+TEST_F(Test, AdaptersRev) {
+	std::vector<int> a{1, 2, 3, 4, 5};
+	auto rev = rusty::MakeRev(rusty::slice::MakeIter(a).copied());
+	ASSERT_EQ(rusty::detail::size_hint(rev), rusty::SizeHint(5, 5));
+	ASSERT_EQ(rev.next().unwrap(), 5);
+	ASSERT_EQ(rev.next_back().unwrap(), 1);
+	ASSERT_EQ(collect(std::move(rev)), std::vector<int>({4, 3, 2}));
+
+	auto rev_rev = rusty::MakeRev(rusty::MakeRev(
+		rusty::NewDoubleEndedIterator(rusty::slice::MakeIter(a).copied())
+	));
+	ASSERT_EQ(collect(std::move(rev_rev)), a);
+}
+
+TEST_F(Test, AdaptersUnchecked) {
+	auto a = iota(10);
+	auto b = iota(4);
+	auto chain = [&](size_t skip, size_t take) {
+		return rusty::MakeZip(
+			rusty::MakeTake(
+				rusty::MakeSkip(rusty::MakeEnumerate(rusty::slice::MakeIter(a)),
+					skip),
+				take
+			),
+			rusty::MakeMap(rusty::slice::MakeIter(b).copied(),
+				[](int x) { return x * 10; })
+		);
+	};
+	static_assert(rusty::detail::HasNextUnchecked<decltype(chain(0, 0))>::value);
+	// Filter can't know its length, so it stays checked.
+	auto filter = rusty::MakeFilter(
+		rusty::slice::MakeIter(a), [](rusty::Ref<const int>) { return true; }
+	);
+	static_assert(!rusty::detail::HasNextUnchecked<decltype(filter)>::value);
+
+	auto sum = [&](size_t skip, size_t take) {
+		return rusty::fold(chain(skip, take), (size_t)0,
+			[](size_t acc, auto x) {
+				return acc + x.first.first * x.second;
+			});
+	};
+	// Zipped with the 4 items of "b".
+	ASSERT_EQ(sum(0, 100), 0 * 0 + 1 * 10 + 2 * 20 + 3 * 30);
+	ASSERT_EQ(sum(8, 100), 8 * 0 + 9 * 10);
+	ASSERT_EQ(sum(2, 1), 2 * 0);
+	ASSERT_EQ(sum(20, 100), 0);
+	ASSERT_EQ(sum(0, 0), 0);
+
+	std::vector<size_t> indices;
+	rusty::for_each(chain(3, 2), [&](auto x) {
+		indices.push_back(x.first.first);
+	});
+	ASSERT_EQ(indices, std::vector<size_t>({3, 4}));
+}
@@ -0,0 +1,76 @@
+#include "rusty/iter/external_sort.h"
+#include "test.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+template <typename T>
+std::vector<T> drain(std::unique_ptr<rusty::Peek<T>> iter) {
+	std::vector<T> v;
+	rusty::collect_into(std::move(iter), v);
+	return v;
+}
+} // namespace
+
+TEST_F(Test, ExternalSorterRandom) {
+	std::mt19937 rng(233);
+	for (size_t n : {0, 1, 10, 1000, 20000}) {
+		rusty::ExternalSorter<uint32_t> sorter(1000);
+		std::vector<uint32_t> expected;
+		for (size_t i = 0; i < n; ++i) {
+			uint32_t x = rng() % 5000;
+			expected.push_back(x);
+			ASSERT_TRUE(sorter.push(x).is_ok());
+		}
+		std::sort(expected.begin(), expected.end());
+		if (n > 1000) {
+			// Replacement selection makes runs about twice as long as the heap.
+			ASSERT_LT(sorter.spilled_runs(), n / 1000);
+		} else {
+			ASSERT_EQ(sorter.spilled_runs(), 0);
+		}
+		auto iter = std::move(sorter).finish().unwrap();
+		ASSERT_EQ(iter->size_hint().first, n);
+		if (n != 0) {
+			ASSERT_EQ(*iter->peek(), expected[0]);
+		}
+		ASSERT_EQ(drain(std::move(iter)), expected);
+	}
+}
+
+TEST_F(Test, ExternalSorterStrings) {
+	// Descending input puts every item into a new run after the first ones,
+	// the worst case for replacement selection. The many short runs also go
+	// through several levels of intermediate merges.
+	constexpr size_t kMaxItems = 4;
+	constexpr int kN = 2000;
+	rusty::ExternalSorter<std::string, rusty::StringSerde> sorter(kMaxItems);
+	std::vector<std::string> expected;
+	for (int i = kN - 1; i >= 0; --i) {
+		char key[16];
+		snprintf(key, sizeof(key), "key%06d", i);
+		expected.push_back(key);
+		ASSERT_TRUE(sorter.push(expected.back()).is_ok());
+	}
+	// Every run has exactly "kMaxItems" items, and the last one stays in
+	// memory.
+	ASSERT_EQ(sorter.spilled_runs(), kN / kMaxItems - 1);
+	ASSERT_GT(sorter.spilled_runs(), decltype(sorter)::kMaxFanIn *
+		decltype(sorter)::kMaxFanIn);
+	std::reverse(expected.begin(), expected.end());
+	auto iter = std::move(sorter).finish().unwrap();
+	ASSERT_EQ(drain(std::move(iter)), expected);
+}
+
+TEST_F(Test, ExternalSorterError) {
+	rusty::ExternalSorter<int> sorter(1, "/nonexistent-dir");
+	ASSERT_TRUE(sorter.push(1).is_ok());
+	auto ret = sorter.push(2);
+	ASSERT_TRUE(ret.is_err());
+	ASSERT_EQ(
+		std::move(ret).unwrap_err().kind(), rusty::io::ErrorKind::NotFound
+	);
+}
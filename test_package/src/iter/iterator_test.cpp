@@ -1,4 +1,5 @@
 #include "rusty/iter/iterator.h"
+#include "rusty/iter/peekable.h"
 #include "test.h"
 
 #include <gtest/gtest.h>
@@ -29,3 +30,143 @@ TEST_F(Test, IteratorSimple) {
 	rusty::collect_into(std::move(iter), b);
 	ASSERT_NO_FATAL_FAILURE(check(a, b));
 }
+
+TEST_F(Test, IteratorNextBatch) {
+	std::vector<int> a{1, 3, 8, 2, 5};
+	std::vector<rusty::Ref<const int>> b;
+	auto it = rusty::slice::MakeIter(a);
+	ASSERT_EQ(it.next_batch(b, 0), 0);
+	ASSERT_EQ(it.next_batch(b, 2), 2);
+	ASSERT_EQ(it.next().unwrap().deref(), 8);
+	ASSERT_EQ(it.next_batch(b, 10), 2);
+	ASSERT_EQ(it.next_batch(b, 10), 0);
+	ASSERT_NO_FATAL_FAILURE(check({1, 3, 2, 5}, b));
+
+	std::unique_ptr<rusty::Iterator<rusty::Ref<const int>>> iter =
+		rusty::NewIterator(rusty::slice::MakeIter(a));
+	b.clear();
+	ASSERT_EQ(iter->next_batch(b, 3), 3);
+	ASSERT_EQ(iter->next_batch(b, 3), 2);
+	ASSERT_EQ(iter->next_batch(b, 3), 0);
+	ASSERT_NO_FATAL_FAILURE(check(a, b));
+}
+
+namespace {
+
+void check_hint(
+	const rusty::SizeHint &hint, size_t lower, rusty::Option<size_t> upper
+) {
+	ASSERT_EQ(hint.first, lower);
+	ASSERT_TRUE(hint.second == upper);
+}
+
+} // namespace
+
+TEST_F(Test, IteratorSizeHint) {
+	std::vector<int> a{1, 3, 8};
+	auto it = rusty::slice::MakeIter(a);
+	ASSERT_NO_FATAL_FAILURE(check_hint(it.size_hint(), 3, 3));
+	it.next();
+	ASSERT_NO_FATAL_FAILURE(check_hint(it.size_hint(), 2, 2));
+
+	auto peekable = rusty::MakePeekable(rusty::slice::MakeIter(a));
+	peekable.peek();
+	ASSERT_NO_FATAL_FAILURE(check_hint(peekable.size_hint(), 3, 3));
+	auto peek = rusty::NewPeek(std::move(peekable));
+	peek->next();
+	ASSERT_NO_FATAL_FAILURE(check_hint(peek->size_hint(), 2, 2));
+
+	// Forwarded through trait objects.
+	auto dyn = rusty::NewIterator(rusty::slice::MakeIter(a));
+	ASSERT_NO_FATAL_FAILURE(check_hint(dyn->size_hint(), 3, 3));
+
+	ASSERT_NO_FATAL_FAILURE(check_hint(
+		rusty::detail::size_hint_add({1, 2}, {SIZE_MAX, rusty::None}),
+		SIZE_MAX, rusty::None
+	));
+	ASSERT_NO_FATAL_FAILURE(check_hint(
+		rusty::detail::size_hint_add({1, 2}, {3, SIZE_MAX}), 4, rusty::None
+	));
+}
+
+TEST_F(Test, CollectIntoReserves) {
+	std::vector<int> a(1000);
+	std::vector<rusty::Ref<const int>> b;
+	rusty::collect_into(rusty::slice::MakeIter(a), b);
+	ASSERT_EQ(b.capacity(), 1000);
+	rusty::collect_into(rusty::slice::MakeIter(a.data(), a.data() + 10), b);
+	// Grows geometrically instead of to the exact size.
+	ASSERT_EQ(b.size(), 1010);
+	ASSERT_GE(b.capacity(), 2000);
+}
+
+TEST_F(Test, SliceIterRange) {
+	std::vector<int> a{1, 3, 8, 2, 5};
+	auto it = rusty::slice::MakeIter(a);
+	it.next();
+	ASSERT_EQ(std::vector<int>(it.begin(), it.end()),
+		(std::vector<int>{3, 8, 2, 5}));
+
+	std::vector<int> v{7};
+	auto copied = it.copied();
+	ASSERT_EQ(copied.next().unwrap(), 3);
+	rusty::collect_into(std::move(copied), v);
+	ASSERT_EQ(v, (std::vector<int>{7, 8, 2, 5}));
+
+	std::vector<std::string> strs{"a", "b", "c"};
+	std::vector<std::string> out;
+	rusty::collect_into(rusty::slice::MakeIter(strs).copied(), out);
+	ASSERT_EQ(out, strs);
+}
+
+TEST_F(Test, SliceChunksWindows) {
+	std::vector<int> a{1, 2, 3, 4, 5};
+	auto chunks = rusty::slice::MakeIter(a).chunks(2);
+	ASSERT_EQ(chunks.size_hint(rusty::type_tag_t<
+		rusty::Iterator<rusty::slice::Iter<int>>>()).first, 3);
+	std::vector<std::vector<int>> got;
+	for (;;) {
+		auto chunk = chunks.next();
+		if (chunk.is_none()) {
+			break;
+		}
+		auto c = std::move(chunk).unwrap();
+		got.emplace_back(c.begin(), c.end());
+	}
+	ASSERT_EQ(got, (std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}}));
+
+	got.clear();
+	auto windows = rusty::slice::MakeIter(a).windows(3);
+	for (;;) {
+		auto window = windows.next();
+		if (window.is_none()) {
+			break;
+		}
+		auto w = std::move(window).unwrap();
+		got.emplace_back(w.begin(), w.end());
+	}
+	ASSERT_EQ(got,
+		(std::vector<std::vector<int>>{{1, 2, 3}, {2, 3, 4}, {3, 4, 5}}));
+	ASSERT_TRUE(rusty::slice::MakeIter(a).windows(6).next().is_none());
+}
+
+TEST_F(Test, SliceIterNextBack) {
+	std::vector<int> a{1, 2, 3, 4};
+	auto iter = rusty::slice::MakeIter(a);
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 4);
+	ASSERT_EQ(iter.next().unwrap().deref(), 1);
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 3);
+	ASSERT_EQ(iter.size_hint(), rusty::SizeHint(1, 1));
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 2);
+	ASSERT_TRUE(iter.next_back().is_none());
+	ASSERT_TRUE(iter.next().is_none());
+
+	auto iter_dyn = rusty::NewDoubleEndedIterator(
+		rusty::slice::MakeIter(a).copied()
+	);
+	ASSERT_EQ(iter_dyn->next_back().unwrap(), 4);
+	ASSERT_EQ(iter_dyn->next().unwrap(), 1);
+	std::vector<int> rest;
+	ASSERT_EQ(iter_dyn->next_batch(rest, 10), 2);
+	ASSERT_EQ(rest, std::vector<int>({2, 3}));
+}
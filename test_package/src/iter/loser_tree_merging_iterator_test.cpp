@@ -0,0 +1,87 @@
+#include "rusty/iter/loser_tree_merging_iterator.h"
+#include "test.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+void check_equal(
+	const std::vector<rusty::Ref<const int>> &a, const std::vector<int> &b
+) {
+	ASSERT_EQ(a.size(), b.size());
+	for (size_t i = 0; i < a.size(); ++i) {
+		ASSERT_EQ(a[i].deref(), b[i]);
+	}
+}
+
+std::vector<rusty::Ref<const int>> merge(
+	const std::vector<std::vector<int>> &runs
+) {
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run))
+		));
+	}
+	std::vector<rusty::Ref<const int>> v;
+	rusty::collect_into(
+		rusty::NewLoserTreeMergingIterator(std::move(iters)), v
+	);
+	return v;
+}
+} // namespace
+
+TEST_F(Test, LoserTreeMergingIteratorSimple) {
+	ASSERT_TRUE(merge({}).empty());
+	ASSERT_TRUE(merge({{}}).empty());
+	ASSERT_TRUE(merge({{}, {}, {}}).empty());
+	ASSERT_NO_FATAL_FAILURE(check_equal(merge({{1, 3, 5}}), {1, 3, 5}));
+	ASSERT_NO_FATAL_FAILURE(
+		check_equal(merge({{}, {2, 4}, {}}), {2, 4})
+	);
+	ASSERT_NO_FATAL_FAILURE(check_equal(
+		merge({{0, 2, 4, 6, 8}, {1, 3, 5, 7, 9}}),
+		{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}
+	));
+	ASSERT_NO_FATAL_FAILURE(check_equal(
+		merge({{1, 1, 4}, {1, 5}, {1, 4}}), {1, 1, 1, 1, 4, 4, 5}
+	));
+}
+
+TEST_F(Test, LoserTreeMergingIteratorRandom) {
+	std::mt19937 rng(233);
+	for (size_t k = 1; k <= 33; ++k) {
+		std::vector<std::vector<int>> runs(k);
+		std::vector<int> expected;
+		for (auto &run : runs) {
+			size_t len = rng() % 20;
+			for (size_t i = 0; i < len; ++i) {
+				run.push_back(rng() % 100);
+			}
+			std::sort(run.begin(), run.end());
+			expected.insert(expected.end(), run.begin(), run.end());
+		}
+		std::sort(expected.begin(), expected.end());
+		ASSERT_NO_FATAL_FAILURE(check_equal(merge(runs), expected));
+	}
+}
+
+TEST_F(Test, LoserTreeMergingIteratorSizeHint) {
+	std::vector<int> a{0, 2, 4};
+	std::vector<int> b{1, 3};
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(a))
+	));
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(b))
+	));
+	auto iter = rusty::NewLoserTreeMergingIterator(std::move(iters));
+	for (size_t remaining = 5; remaining > 0; --remaining) {
+		ASSERT_EQ(iter->size_hint().first, remaining);
+		iter->next();
+	}
+	ASSERT_TRUE(iter->next().is_none());
+	ASSERT_EQ(iter->size_hint().second.unwrap(), 0);
+}
@@ -1,7 +1,11 @@
+#include "rusty/iter/adapters.h"
 #include "rusty/iter/merging_iterator.h"
 #include "test.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <random>
+#include <string>
 
 namespace {
 void check_equal(
@@ -194,3 +198,142 @@ TEST_F(Test, MergingIteratorSimple) {
 		ASSERT_NO_FATAL_FAILURE(check(std::move(iter), 0, 10, 1));
 	}
 }
+
+TEST_F(Test, MergingIteratorNextBatch) {
+	std::vector<int> a{0, 2, 4, 6, 8};
+	std::vector<int> b{1, 3, 5, 7, 9};
+	std::vector<int> c{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(a))
+	));
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(b))
+	));
+	auto iter = rusty::NewMergingIterator(std::move(iters));
+	std::vector<rusty::Ref<const int>> v;
+	ASSERT_EQ(iter->next_batch(v, 3), 3);
+	ASSERT_EQ(iter->next().unwrap().deref(), 3);
+	ASSERT_EQ(iter->next_batch(v, 100), 6);
+	ASSERT_EQ(iter->next_batch(v, 100), 0);
+	c.erase(c.begin() + 3);
+	ASSERT_NO_FATAL_FAILURE(check_equal(v, c));
+}
+
+TEST_F(Test, MergingIteratorSizeHint) {
+	std::vector<int> a{0, 2, 4};
+	std::vector<int> b{1, 3};
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(a))
+	));
+	iters.push_back(rusty::NewPeek(
+		rusty::MakePeekable(rusty::slice::MakeIter(b))
+	));
+	auto iter = rusty::NewMergingIterator(std::move(iters));
+	for (size_t remaining = 5; remaining > 0; --remaining) {
+		auto hint = iter->size_hint();
+		ASSERT_EQ(hint.first, remaining);
+		ASSERT_EQ(std::move(hint.second).unwrap(), remaining);
+		iter->next();
+	}
+	ASSERT_EQ(iter->size_hint().first, 0);
+	ASSERT_TRUE(iter->next().is_none());
+	ASSERT_EQ(iter->size_hint().second.unwrap(), 0);
+}
+
+TEST_F(Test, MergingIteratorDropEarly) {
+	std::vector<int> a{0, 2, 4};
+	std::vector<int> b{1, 3};
+	std::vector<int> c{5};
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	for (const auto *v : {&a, &b, &c}) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(*v))
+		));
+	}
+	auto iter = rusty::NewMergingIterator(std::move(iters));
+	ASSERT_EQ(iter->next().unwrap().deref(), 0);
+	ASSERT_EQ(iter->next().unwrap().deref(), 1);
+	// Dropped with a pending top.
+}
+
+TEST_F(Test, StringPrefixKey) {
+	ASSERT_EQ(rusty::string_prefix_key(""), 0);
+	ASSERT_EQ(rusty::string_prefix_key("a"), 0x61ull << 56);
+	ASSERT_EQ(
+		rusty::string_prefix_key("abcdefgh"),
+		rusty::string_prefix_key("abcdefghij")
+	);
+	ASSERT_LT(
+		rusty::string_prefix_key("ab"), rusty::string_prefix_key("ab\x01")
+	);
+	ASSERT_LT(
+		rusty::string_prefix_key("a\x7f"), rusty::string_prefix_key("a\x80")
+	);
+}
+
+TEST_F(Test, MergingIteratorPrefixKey) {
+	using Key = rusty::Ref<const std::string>;
+	std::mt19937 rng(233);
+	std::vector<std::vector<std::string>> runs(7);
+	std::vector<std::string> expected;
+	for (auto &run : runs) {
+		size_t len = rng() % 50;
+		for (size_t i = 0; i < len; ++i) {
+			// Many keys share the first 8 bytes, so that ties on the prefix
+			// key fall back to the full comparison.
+			run.push_back(
+				std::string(rng() % 10, 'k') + std::to_string(rng() % 100)
+			);
+		}
+		std::sort(run.begin(), run.end());
+		expected.insert(expected.end(), run.begin(), run.end());
+	}
+	std::sort(expected.begin(), expected.end());
+
+	std::vector<std::unique_ptr<rusty::Peek<Key>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run))
+		));
+	}
+	auto iter = rusty::NewMergingIterator(
+		std::move(iters),
+		rusty::MakePrefixKeyCompare<Key>([](const Key &key) {
+			return rusty::string_prefix_key(key.deref());
+		})
+	);
+	std::vector<Key> v;
+	rusty::collect_into(std::move(iter), v);
+	ASSERT_EQ(v.size(), expected.size());
+	for (size_t i = 0; i < v.size(); ++i) {
+		ASSERT_EQ(v[i].deref(), expected[i]);
+	}
+}
+
+TEST_F(Test, ReverseMergingIterator) {
+	std::mt19937 rng(233);
+	std::vector<std::vector<int>> runs(9);
+	std::vector<int> expected;
+	for (auto &run : runs) {
+		size_t len = rng() % 20;
+		for (size_t i = 0; i < len; ++i) {
+			run.push_back(rng() % 100);
+		}
+		std::sort(run.begin(), run.end());
+		expected.insert(expected.end(), run.begin(), run.end());
+	}
+	std::sort(expected.rbegin(), expected.rend());
+
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(rusty::MakePeekable(
+			rusty::MakeRev(rusty::slice::MakeIter(run))
+		)));
+	}
+	std::vector<rusty::Ref<const int>> v;
+	rusty::collect_into(rusty::NewReverseMergingIterator(std::move(iters)), v);
+	ASSERT_NO_FATAL_FAILURE(check_equal(v, expected));
+}
@@ -0,0 +1,77 @@
+#include "rusty/iter/parallel_merge.h"
+#include "test.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+
+namespace {
+void check(const std::vector<std::vector<int>> &data, size_t threads) {
+	std::vector<rusty::slice::Iter<int>> runs;
+	std::vector<int> expected;
+	for (const auto &run : data) {
+		runs.push_back(rusty::slice::MakeIter(run));
+		expected.insert(expected.end(), run.begin(), run.end());
+	}
+	std::sort(expected.begin(), expected.end());
+	std::vector<int> out;
+	rusty::parallel_merge_into(runs, out, threads);
+	ASSERT_EQ(out, expected);
+}
+
+std::vector<std::vector<int>> make_runs(
+	std::mt19937 &rng, size_t k, size_t total, int max
+) {
+	std::vector<std::vector<int>> runs(k);
+	for (size_t i = 0; i < total; ++i) {
+		// Skewed run lengths
+		runs[rng() % k % (rng() % k + 1)].push_back(rng() % max);
+	}
+	for (auto &run : runs) {
+		std::sort(run.begin(), run.end());
+	}
+	return runs;
+}
+} // namespace
+
+TEST_F(Test, ParallelMerge) {
+	ASSERT_NO_FATAL_FAILURE(check({}, 4));
+	ASSERT_NO_FATAL_FAILURE(check({{}, {}}, 4));
+	ASSERT_NO_FATAL_FAILURE(check({{1, 3, 5}, {}, {2, 4}}, 4));
+
+	std::mt19937 rng(233);
+	for (size_t threads : {1, 2, 3, 8}) {
+		for (size_t k : {1, 2, 7, 64}) {
+			auto runs = make_runs(rng, k, 40000, 1 << 30);
+			ASSERT_NO_FATAL_FAILURE(check(runs, threads));
+			// Lots of duplicates
+			runs = make_runs(rng, k, 40000, 3);
+			ASSERT_NO_FATAL_FAILURE(check(runs, threads));
+		}
+	}
+}
+
+TEST_F(Test, ParallelMergeThrows) {
+	std::mt19937 rng(233);
+	auto data = make_runs(rng, 8, 100000, 1 << 30);
+	std::vector<rusty::slice::Iter<int>> runs;
+	int max = 0;
+	for (const auto &run : data) {
+		runs.push_back(rusty::slice::MakeIter(run));
+		if (!run.empty()) {
+			max = std::max(max, run.back());
+		}
+	}
+	// Throws in the last range, which the calling thread merges while the
+	// workers are still running.
+	auto cmp = [max](int a, int b) {
+		if (a == max || b == max) {
+			throw std::runtime_error("cmp");
+		}
+		return a < b;
+	};
+	std::vector<int> out;
+	ASSERT_THROW(rusty::parallel_merge_into(runs, out, 4, cmp),
+		std::runtime_error);
+}
@@ -14,6 +14,16 @@ void check(I &&iter, const std::vector<size_t> &a) {
 	ASSERT_TRUE(iter.peek() == nullptr);
 	ASSERT_TRUE(iter.next().is_none());
 }
+
+void check_batch(
+	const std::vector<rusty::Ref<const size_t>> &b,
+	const std::vector<size_t> &a
+) {
+	ASSERT_EQ(b.size(), a.size());
+	for (size_t i = 0; i < a.size(); ++i) {
+		ASSERT_EQ(b[i].deref(), a[i]);
+	}
+}
 } // namespace
 
 TEST_F(Test, PeekableSimple) {
@@ -41,3 +51,37 @@ TEST_F(Test, PeekableSimple) {
 		a
 	));
 }
+
+TEST_F(Test, PeekableNextBatch) {
+	std::vector<size_t> a{0, 1, 2, 3, 4};
+	std::vector<rusty::Ref<const size_t>> b;
+	auto iter = rusty::MakePeekable(rusty::slice::MakeIter(a));
+	ASSERT_EQ(iter.peek()->deref(), 0);
+	ASSERT_EQ(iter.next_batch(b, 0), 0);
+	ASSERT_EQ(iter.next_batch(b, 1), 1);
+	ASSERT_EQ(iter.peek()->deref(), 1);
+	ASSERT_EQ(iter.next_batch(b, 3), 3);
+	ASSERT_EQ(iter.next_batch(b, 3), 1);
+	ASSERT_TRUE(iter.peek() == nullptr);
+	ASSERT_NO_FATAL_FAILURE(check_batch(b, a));
+
+	auto peek = rusty::NewPeek(rusty::MakePeekable(
+		rusty::NewIterator(rusty::slice::MakeIter(a))
+	));
+	ASSERT_EQ(peek->peek()->deref(), 0);
+	b.clear();
+	ASSERT_EQ(peek->next_batch(b, 10), 5);
+	ASSERT_NO_FATAL_FAILURE(check_batch(b, a));
+}
+
+TEST_F(Test, PeekableNextBack) {
+	std::vector<size_t> a{0, 1, 2};
+	auto iter = rusty::MakePeekable(rusty::slice::MakeIter(a));
+	ASSERT_EQ(iter.peek()->deref(), 0);
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 2);
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 1);
+	// The peeked item is the last one from the back.
+	ASSERT_EQ(iter.next_back().unwrap().deref(), 0);
+	ASSERT_TRUE(iter.next_back().is_none());
+	ASSERT_TRUE(iter.peek() == nullptr);
+}
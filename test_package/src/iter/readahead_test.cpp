@@ -0,0 +1,71 @@
+#include "rusty/iter/merging_iterator.h"
+#include "rusty/iter/readahead.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+
+TEST_F(Test, Readahead) {
+	std::vector<int> a(10000);
+	std::iota(a.begin(), a.end(), 0);
+	{
+		auto iter = rusty::MakeReadahead(
+			rusty::slice::MakeIter(a.data(), a.data())
+		);
+		ASSERT_TRUE(iter.peek() == nullptr);
+		ASSERT_TRUE(iter.next().is_none());
+		ASSERT_TRUE(iter.next().is_none());
+	}
+	for (size_t capacity : {1, 3, 1024}) {
+		auto iter = rusty::MakeReadahead(rusty::slice::MakeIter(a), capacity);
+		std::vector<rusty::Ref<const int>> v;
+		for (size_t i = 0; i < a.size(); ++i) {
+			if (i % 3 == 0) {
+				ASSERT_EQ(iter.peek()->deref(), a[i]);
+			}
+			if (i % 5 == 0) {
+				v.clear();
+				ASSERT_EQ(iter.next_batch(v, 1), 1);
+				ASSERT_EQ(v[0].deref(), a[i]);
+			} else {
+				ASSERT_EQ(iter.next().unwrap().deref(), a[i]);
+			}
+		}
+		ASSERT_TRUE(iter.peek() == nullptr);
+		ASSERT_TRUE(iter.next().is_none());
+	}
+	{
+		auto iter = rusty::MakeReadahead(
+			rusty::NewIterator(rusty::slice::MakeIter(a)), 16
+		);
+		std::vector<rusty::Ref<const int>> v;
+		rusty::collect_into(std::move(iter), v);
+		ASSERT_EQ(v.size(), a.size());
+		for (size_t i = 0; i < a.size(); ++i) {
+			ASSERT_EQ(v[i].deref(), a[i]);
+		}
+	}
+	// Dropped before the wrapped iterator is exhausted.
+	{
+		auto iter = rusty::MakeReadahead(rusty::slice::MakeIter(a), 4);
+		ASSERT_EQ(iter.next().unwrap().deref(), 0);
+	}
+}
+
+TEST_F(Test, ReadaheadMerging) {
+	std::vector<int> a{0, 2, 4, 6, 8};
+	std::vector<int> b{1, 3, 5, 7, 9};
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const int>>>> iters;
+	iters.push_back(rusty::NewPeek(
+		rusty::MakeReadahead(rusty::slice::MakeIter(a))
+	));
+	iters.push_back(rusty::NewPeek(
+		rusty::MakeReadahead(rusty::slice::MakeIter(b))
+	));
+	std::vector<rusty::Ref<const int>> v;
+	rusty::collect_into(rusty::NewMergingIterator(std::move(iters)), v);
+	ASSERT_EQ(v.size(), 10);
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_EQ(v[i].deref(), i);
+	}
+}
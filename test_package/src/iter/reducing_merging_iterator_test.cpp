@@ -0,0 +1,84 @@
+#include "rusty/iter/reducing_merging_iterator.h"
+#include "test.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+
+namespace {
+using Entry = std::pair<int, size_t>;
+
+std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const Entry>>>> make_iters(
+	const std::vector<std::vector<Entry>> &runs
+) {
+	std::vector<std::unique_ptr<rusty::Peek<rusty::Ref<const Entry>>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run))
+		));
+	}
+	return iters;
+}
+} // namespace
+
+TEST_F(Test, ReducingMergingIteratorKeepNewest) {
+	using Ref = rusty::Ref<const Entry>;
+	std::mt19937 rng(233);
+	std::vector<std::vector<Entry>> runs(9);
+	// key -> the smallest index of the sources that contain the key
+	std::map<int, size_t> expected;
+	for (size_t i = 0; i < runs.size(); ++i) {
+		size_t len = rng() % 30;
+		for (size_t j = 0; j < len; ++j) {
+			int key = rng() % 50;
+			runs[i].emplace_back(key, i);
+			expected.emplace(key, i);
+		}
+		std::sort(runs[i].begin(), runs[i].end());
+	}
+	auto iter = rusty::NewReducingMergingIterator(
+		make_iters(runs),
+		rusty::KeepNewest(),
+		[](Ref a, Ref b) { return a->first < b->first; },
+		[](Ref a, Ref b) { return a->first == b->first; }
+	);
+	std::vector<Ref> v;
+	rusty::collect_into(std::move(iter), v);
+	ASSERT_EQ(v.size(), expected.size());
+	size_t i = 0;
+	for (const auto &[key, index] : expected) {
+		ASSERT_EQ(v[i]->first, key);
+		ASSERT_EQ(v[i]->second, index);
+		++i;
+	}
+}
+
+TEST_F(Test, ReducingMergingIteratorSum) {
+	std::vector<std::vector<Entry>> runs{
+		{{1, 1}, {1, 2}, {3, 3}, {5, 4}}, {}, {{1, 5}, {2, 6}, {5, 7}}, {{5, 8}}
+	};
+	std::vector<std::unique_ptr<rusty::Peek<Entry>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewPeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run).copied())
+		));
+	}
+	auto iter = rusty::NewReducingMergingIterator(
+		std::move(iters),
+		[](Entry acc, Entry x) {
+			acc.second += x.second;
+			return acc;
+		},
+		[](const Entry &a, const Entry &b) { return a.first < b.first; },
+		[](const Entry &a, const Entry &b) { return a.first == b.first; }
+	);
+	ASSERT_EQ(iter->size_hint(), rusty::SizeHint(1, 8));
+	ASSERT_EQ(iter->next().unwrap(), Entry(1, 8));
+	ASSERT_EQ(iter->size_hint(), rusty::SizeHint(1, 5));
+	std::vector<Entry> v;
+	ASSERT_EQ(iter->next_batch(v, 10), 3);
+	ASSERT_EQ(v, std::vector<Entry>({{2, 6}, {3, 3}, {5, 19}}));
+	ASSERT_EQ(iter->size_hint(), rusty::SizeHint(0, 0));
+	ASSERT_TRUE(iter->next().is_none());
+}
@@ -0,0 +1,85 @@
+#include "rusty/iter/seekable_merging_iterator.h"
+#include "test.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+TEST_F(Test, SliceIterSeek) {
+	std::vector<int> v;
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(i / 3 * 2);
+	}
+	auto iter = rusty::slice::MakeIter(v);
+	for (int target = -1; target <= 70; ++target) {
+		iter.seek(target);
+		auto expected = std::lower_bound(v.begin(), v.end(), target);
+		ASSERT_EQ(iter.len(), static_cast<size_t>(v.end() - expected));
+	}
+	// Seeking backward does nothing.
+	iter = rusty::slice::MakeIter(v);
+	iter.seek(50);
+	iter.seek(10);
+	ASSERT_EQ(iter.next().unwrap().deref(), 50);
+}
+
+TEST_F(Test, PeekableSeek) {
+	std::vector<int> v{1, 3, 5, 7};
+	auto iter = rusty::MakePeekable(rusty::slice::MakeIter(v));
+	ASSERT_EQ(iter.peek()->deref(), 1);
+	// The peeked item is kept if it is not less than the target.
+	iter.seek(1);
+	ASSERT_EQ(iter.peek()->deref(), 1);
+	iter.seek(4);
+	ASSERT_EQ(iter.peek()->deref(), 5);
+	ASSERT_EQ(iter.size_hint(), rusty::SizeHint(2, 2));
+	iter.seek(8);
+	ASSERT_EQ(iter.peek(), nullptr);
+}
+
+TEST_F(Test, SeekableMergingIteratorRandom) {
+	using Ref = rusty::Ref<const int>;
+	std::mt19937 rng(233);
+	std::vector<std::vector<int>> runs(13);
+	std::vector<int> all;
+	for (auto &run : runs) {
+		size_t len = rng() % 100;
+		for (size_t i = 0; i < len; ++i) {
+			run.push_back(rng() % 1000);
+		}
+		std::sort(run.begin(), run.end());
+		all.insert(all.end(), run.begin(), run.end());
+	}
+	std::sort(all.begin(), all.end());
+
+	std::vector<std::unique_ptr<rusty::Seek<Ref>>> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::NewSeek(
+			rusty::MakePeekable(rusty::slice::MakeIter(run))
+		));
+	}
+	auto iter = rusty::NewSeekableMergingIterator(std::move(iters));
+	// Scans up to 5 items from increasing targets.
+	int target = 0;
+	auto pos = all.begin();
+	while (target < 1100) {
+		int key = target;
+		iter->seek(key);
+		pos = std::max(pos, std::lower_bound(all.begin(), all.end(), target));
+		auto hint = iter->size_hint();
+		ASSERT_EQ(hint.first, static_cast<size_t>(all.end() - pos));
+		if (pos != all.end()) {
+			ASSERT_EQ(iter->peek()->deref(), *pos);
+		}
+		for (size_t i = 0; i < 5; ++i) {
+			auto ret = iter->next();
+			if (pos == all.end()) {
+				ASSERT_TRUE(ret.is_none());
+				break;
+			}
+			ASSERT_EQ(std::move(ret).unwrap().deref(), *pos);
+			++pos;
+		}
+		target += rng() % 50;
+	}
+}
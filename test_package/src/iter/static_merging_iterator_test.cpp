@@ -0,0 +1,83 @@
+#include "rusty/iter/adapters.h"
+#include "rusty/iter/static_merging_iterator.h"
+#include "test.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+using Iter = rusty::Peekable<rusty::slice::Iter<int>>;
+
+std::vector<Iter> make_iters(const std::vector<std::vector<int>> &runs) {
+	std::vector<Iter> iters;
+	for (const auto &run : runs) {
+		iters.push_back(rusty::MakePeekable(rusty::slice::MakeIter(run)));
+	}
+	return iters;
+}
+} // namespace
+
+TEST_F(Test, StaticMergingIteratorRandom) {
+	std::mt19937 rng(233);
+	for (size_t k = 0; k <= 33; ++k) {
+		std::vector<std::vector<int>> runs(k);
+		std::vector<int> expected;
+		for (auto &run : runs) {
+			size_t len = rng() % 20;
+			for (size_t i = 0; i < len; ++i) {
+				run.push_back(rng() % 100);
+			}
+			std::sort(run.begin(), run.end());
+			expected.insert(expected.end(), run.begin(), run.end());
+		}
+		std::sort(expected.begin(), expected.end());
+		auto iter = rusty::MakeStaticMergingIterator(make_iters(runs));
+		std::vector<int> merged;
+		for (;;) {
+			auto ret = iter.next();
+			if (ret.is_none()) {
+				break;
+			}
+			merged.push_back(std::move(ret).unwrap().deref());
+		}
+		ASSERT_EQ(merged, expected);
+	}
+}
+
+TEST_F(Test, StaticMergingIteratorCompare) {
+	std::vector<std::vector<int>> runs{{4, 2, 0}, {}, {5, 3, 1}};
+	auto iter = rusty::MakeStaticMergingIterator(
+		make_iters(runs),
+		[](rusty::Ref<const int> a, rusty::Ref<const int> b) {
+			return b.deref() < a.deref();
+		}
+	);
+	ASSERT_EQ(iter.size_hint(), rusty::SizeHint(6, 6));
+	std::vector<rusty::Ref<const int>> v;
+	ASSERT_EQ(iter.next_batch(v, 4), 4);
+	ASSERT_EQ(iter.size_hint(), rusty::SizeHint(2, 2));
+	ASSERT_EQ(iter.next_batch(v, 4), 2);
+	ASSERT_EQ(iter.size_hint(), rusty::SizeHint(0, 0));
+	ASSERT_EQ(v.size(), 6);
+	for (size_t i = 0; i < v.size(); ++i) {
+		ASSERT_EQ(v[i].deref(), 5 - (int)i);
+	}
+}
+
+TEST_F(Test, StaticMergingIteratorMove) {
+	std::vector<std::vector<int>> runs{{0, 3, 6}, {1, 4}, {2, 5}};
+	auto iter = rusty::MakeStaticMergingIterator(make_iters(runs));
+	ASSERT_EQ(iter.next().unwrap().deref(), 0);
+	// Moved with a pending top.
+	auto moved = std::move(iter);
+	ASSERT_EQ(moved.next().unwrap().deref(), 1);
+	auto doubled = rusty::MakeMap(
+		std::move(moved), [](rusty::Ref<const int> x) { return x.deref() * 2; }
+	);
+	ASSERT_EQ(doubled.next().unwrap(), 4);
+	auto dyn = rusty::NewIterator(std::move(doubled));
+	std::vector<int> v;
+	rusty::collect_into(std::move(dyn), v);
+	ASSERT_EQ(v, std::vector<int>({6, 8, 10, 12}));
+}
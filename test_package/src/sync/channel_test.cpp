@@ -0,0 +1,149 @@
+#include "rusty/sync/channel.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using rusty::sync::TryRecvError;
+using rusty::sync::TrySendErrorKind;
+
+TEST_F(Test, SpscChannelSimple) {
+	auto [tx, rx] = rusty::sync::spsc::channel<std::string>(2);
+	ASSERT_TRUE(rx.try_recv().unwrap_err() == TryRecvError::Empty);
+	ASSERT_TRUE(tx.try_send("a").is_ok());
+	ASSERT_TRUE(tx.try_send("b").is_ok());
+	auto err = tx.try_send("c").unwrap_err();
+	ASSERT_TRUE(err.kind() == TrySendErrorKind::Full);
+	ASSERT_EQ(std::move(err).into_inner(), "c");
+	ASSERT_EQ(rx.try_recv().unwrap(), "a");
+	ASSERT_TRUE(tx.send("c").is_ok());
+	{ auto dropped = std::move(tx); }
+	// Values sent before the sender is dropped can still be received.
+	ASSERT_EQ(rx.recv().unwrap(), "b");
+	ASSERT_EQ(rx.recv().unwrap(), "c");
+	ASSERT_TRUE(rx.recv().is_none());
+	ASSERT_TRUE(rx.try_recv().unwrap_err() == TryRecvError::Disconnected);
+}
+
+TEST_F(Test, SpscChannelReceiverDropped) {
+	auto [tx, rx] = rusty::sync::spsc::channel<int>(1);
+	ASSERT_TRUE(tx.send(1).is_ok());
+	std::thread t([rx = std::move(rx)]() mutable {
+		ASSERT_EQ(rx.recv().unwrap(), 1);
+	});
+	// Blocks until the receiver is dropped.
+	for (;;) {
+		auto ret = tx.send(2);
+		if (ret.is_err()) {
+			ASSERT_EQ(std::move(ret).unwrap_err().into_inner(), 2);
+			break;
+		}
+	}
+	t.join();
+	auto err = tx.try_send(3).unwrap_err();
+	ASSERT_TRUE(err.kind() == TrySendErrorKind::Disconnected);
+}
+
+TEST_F(Test, SpscChannelThreads) {
+	constexpr int n = 100000;
+	auto [tx, rx] = rusty::sync::spsc::channel<int>(16);
+	std::thread t([tx = std::move(tx)]() mutable {
+		for (int i = 0; i < n; ++i) {
+			ASSERT_TRUE(tx.send(i).is_ok());
+		}
+	});
+	for (int i = 0; i < n; ++i) {
+		ASSERT_EQ(rx.recv().unwrap(), i);
+	}
+	ASSERT_TRUE(rx.recv().is_none());
+	t.join();
+}
+
+TEST_F(Test, MpmcChannelSimple) {
+	auto [tx, rx] = rusty::sync::mpmc::channel<int>(2);
+	auto tx2 = tx.clone();
+	auto rx2 = rx.clone();
+	ASSERT_TRUE(tx.try_send(1).is_ok());
+	ASSERT_TRUE(tx2.try_send(2).is_ok());
+	ASSERT_TRUE(tx.try_send(3).unwrap_err().kind() == TrySendErrorKind::Full);
+	ASSERT_EQ(rx2.try_recv().unwrap(), 1);
+	ASSERT_EQ(rx.try_recv().unwrap(), 2);
+	ASSERT_TRUE(rx.try_recv().unwrap_err() == TryRecvError::Empty);
+
+	ASSERT_TRUE(tx2.send(4).is_ok());
+	{ auto dropped = std::move(tx); }
+	ASSERT_EQ(rx.recv().unwrap(), 4);
+	ASSERT_TRUE(rx.try_recv().unwrap_err() == TryRecvError::Empty);
+	{ auto dropped = std::move(tx2); }
+	ASSERT_TRUE(rx.recv().is_none());
+	ASSERT_TRUE(rx2.try_recv().unwrap_err() == TryRecvError::Disconnected);
+}
+
+TEST_F(Test, SpscChannelMoveAssign) {
+	auto [tx, rx] = rusty::sync::spsc::channel<int>(2);
+	auto [tx2, rx2] = rusty::sync::spsc::channel<int>(2);
+	ASSERT_TRUE(tx.send(1).is_ok());
+	// Drops the old endpoints, which disconnects the first channel.
+	tx = std::move(tx2);
+	rx = std::move(rx2);
+	ASSERT_TRUE(tx.send(2).is_ok());
+	ASSERT_EQ(rx.recv().unwrap(), 2);
+	{ auto dropped = std::move(tx); }
+	ASSERT_TRUE(rx.recv().is_none());
+}
+
+TEST_F(Test, MpmcChannelMoveAssign) {
+	auto [tx, rx] = rusty::sync::mpmc::channel<int>(2);
+	auto [tx2, rx2] = rusty::sync::mpmc::channel<int>(2);
+	auto rx_old = rx.clone();
+	tx = std::move(tx2);
+	// The first channel has no sender left.
+	ASSERT_TRUE(rx_old.recv().is_none());
+	rx = std::move(rx2);
+	ASSERT_TRUE(tx.send(1).is_ok());
+	ASSERT_EQ(rx.recv().unwrap(), 1);
+	{ auto dropped = std::move(rx); }
+	ASSERT_TRUE(
+		tx.try_send(2).unwrap_err().kind() == TrySendErrorKind::Disconnected
+	);
+}
+
+TEST_F(Test, MpmcChannelThreads) {
+	constexpr size_t kThreads = 4;
+	constexpr size_t n = 20000;
+	auto [tx, rx] = rusty::sync::mpmc::channel<size_t>(8);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < kThreads; ++i) {
+		threads.emplace_back([i, tx = tx.clone()]() mutable {
+			for (size_t j = i; j < n; j += kThreads) {
+				ASSERT_TRUE(tx.send(j).is_ok());
+			}
+		});
+	}
+	{ auto dropped = std::move(tx); }
+	std::vector<std::vector<size_t>> received(kThreads);
+	for (size_t i = 0; i < kThreads; ++i) {
+		threads.emplace_back([&received, i, rx = rx.clone()]() mutable {
+			for (;;) {
+				auto ret = rx.recv();
+				if (ret.is_none()) {
+					break;
+				}
+				received[i].push_back(std::move(ret).unwrap());
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	std::vector<bool> seen(n);
+	for (const auto &v : received) {
+		for (size_t x : v) {
+			ASSERT_FALSE(seen[x]);
+			seen[x] = true;
+		}
+	}
+	for (size_t x = 0; x < n; ++x) {
+		ASSERT_TRUE(seen[x]);
+	}
+}
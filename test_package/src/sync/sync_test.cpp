@@ -0,0 +1,124 @@
+#include "rusty/sync.h"
+#include "rusty/sync/adaptive_mutex.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <unordered_map>
+
+TEST_F(Test, MutexTryLock) {
+	rusty::sync::Mutex<int> mutex(1);
+	{
+		auto guard = mutex.try_lock();
+		ASSERT_TRUE(guard.is_some());
+		ASSERT_TRUE(mutex.try_lock().is_none());
+		**guard.as_ptr() = 2;
+	}
+	ASSERT_EQ(*mutex.try_lock().unwrap(), 2);
+}
+
+namespace {
+
+template <typename M>
+void check_mutex_counter(const M &mutex) {
+	constexpr int kThreads = 4;
+	constexpr int kIncrements = 10000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < kThreads; ++i) {
+		threads.emplace_back([&mutex] {
+			for (int j = 0; j < kIncrements; ++j) {
+				if (j % 2 == 0) {
+					++*mutex.lock();
+					continue;
+				}
+				for (;;) {
+					auto guard = mutex.try_lock();
+					if (guard.is_some()) {
+						++**guard.as_ptr();
+						break;
+					}
+				}
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(*mutex.lock(), kThreads * kIncrements);
+}
+
+} // namespace
+
+TEST_F(Test, AdaptiveMutex) {
+	rusty::sync::AdaptiveMutex<int> mutex(0);
+	ASSERT_NO_FATAL_FAILURE(check_mutex_counter(mutex));
+
+	rusty::sync::ProfiledMutex<int> profiled(0);
+	ASSERT_NO_FATAL_FAILURE(check_mutex_counter(profiled));
+	auto stats = profiled.raw().stats();
+	// Failed "try_lock"s are not counted, and the final check locks once.
+	ASSERT_EQ(stats.acquisitions, 4 * 10000 + 1);
+	ASSERT_LE(stats.contended_acquisitions, stats.acquisitions);
+	if (stats.contended_acquisitions == 0) {
+		ASSERT_EQ(stats.wait_time.as_nanos(), 0);
+	}
+}
+
+TEST_F(Test, RwLock) {
+	rusty::sync::RwLock<std::vector<int>> lock(std::vector<int>{1, 2});
+	{
+		auto r1 = lock.read();
+		// Readers do not exclude each other.
+		auto r2 = lock.read();
+		ASSERT_EQ(r1->size(), 2);
+		ASSERT_EQ((*r2)[1], 2);
+	}
+	lock.write()->push_back(3);
+	ASSERT_EQ(lock.read()->back(), 3);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([&lock] {
+			for (int j = 0; j < 1000; ++j) {
+				auto w = lock.write();
+				w->push_back(w->back() + 1);
+			}
+		});
+		threads.emplace_back([&lock] {
+			for (int j = 0; j < 1000; ++j) {
+				auto r = lock.read();
+				ASSERT_EQ(r->back(), (int)r->size());
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(lock.read()->size(), 4003);
+}
+
+TEST_F(Test, ShardedRwLock) {
+	rusty::sync::ShardedRwLock<std::unordered_map<int, int>, 8> map;
+	ASSERT_EQ(map.shards(), 8);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([&map, i] {
+			for (int k = i; k < 1000; k += 4) {
+				(*map.write(k))[k] = k * 2;
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	size_t total = 0;
+	for (size_t i = 0; i < map.shards(); ++i) {
+		total += map.shard(i).read()->size();
+	}
+	ASSERT_EQ(total, 1000);
+	for (int k = 0; k < 1000; ++k) {
+		auto shard = map.read(k);
+		ASSERT_EQ(shard->at(k), k * 2);
+		ASSERT_EQ(&map.shard_for(k), &map.shard(std::hash<int>()(k) % 8));
+	}
+}
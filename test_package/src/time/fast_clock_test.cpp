@@ -0,0 +1,31 @@
+#include "rusty/time/fast_clock.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using rusty::time::CoarseInstant;
+using rusty::time::FastInstant;
+using rusty::time::Instant;
+
+TEST_F(Test, FastInstant) {
+	auto start = Instant::now();
+	auto fast_start = FastInstant::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	auto fast_elapsed = fast_start.elapsed().as_nanos();
+	auto elapsed = start.elapsed().as_nanos();
+	// Allow 5% of calibration error.
+	ASSERT_GE(fast_elapsed, 20000000 - 20000000 / 20);
+	ASSERT_LE(fast_elapsed, elapsed + elapsed / 20);
+	ASSERT_FALSE(FastInstant::now() < fast_start);
+	ASSERT_EQ((fast_start - FastInstant::now()).as_nanos(), 0);
+}
+
+TEST_F(Test, CoarseInstant) {
+	auto start = CoarseInstant::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	auto now = CoarseInstant::now();
+	ASSERT_FALSE(now < start);
+	// Either end may be up to one update period stale.
+	ASSERT_GE((now - start).as_nanos(), 10000000);
+}
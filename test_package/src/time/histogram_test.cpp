@@ -0,0 +1,72 @@
+#include "rusty/time/histogram.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using rusty::time::Duration;
+using rusty::time::Histogram;
+
+TEST_F(Test, HistogramBuckets) {
+	using namespace rusty::time::detail;
+	size_t last = 0;
+	for (uint64_t v = 0; v < 100000; ++v) {
+		size_t b = histogram_bucket(v);
+		ASSERT_TRUE(b == last || b == last + 1);
+		ASSERT_LE(v, histogram_bucket_max(b));
+		ASSERT_LE(histogram_bucket_max(b) - v, v / kSubBuckets);
+		last = b;
+	}
+	ASSERT_EQ(histogram_bucket(UINT64_MAX), kHistogramBuckets - 1);
+	ASSERT_EQ(histogram_bucket_max(kHistogramBuckets - 1), UINT64_MAX);
+}
+
+TEST_F(Test, Histogram) {
+	Histogram h(4);
+	ASSERT_EQ(h.snapshot().count(), 0);
+	ASSERT_EQ(h.snapshot().p99().as_nanos(), 0);
+
+	std::vector<std::thread> threads;
+	for (uint64_t t = 0; t < 4; ++t) {
+		threads.emplace_back([&h, t] {
+			for (uint64_t v = 1 + t; v <= 10000; v += 4) {
+				h.record_nanos(v);
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	auto s = h.snapshot();
+	ASSERT_EQ(s.count(), 10000);
+	ASSERT_EQ(s.max().as_nanos(), 10000);
+	ASSERT_EQ(s.sum().as_nanos(), 10000 * 10001 / 2);
+	ASSERT_EQ(s.mean().as_nanos(), 5000);
+	auto near = [](Duration d, uint64_t expected) {
+		return d.as_nanos() >= expected &&
+			d.as_nanos() <= expected + expected / 32;
+	};
+	ASSERT_TRUE(near(s.p50(), 5000));
+	ASSERT_TRUE(near(s.p99(), 9900));
+	ASSERT_TRUE(near(s.p999(), 9990));
+	ASSERT_EQ(s.quantile(1).as_nanos(), 10000);
+	ASSERT_EQ(s.quantile(0).as_nanos(), 1);
+
+	Histogram other(1);
+	other.record(Duration::from_secs(1));
+	s.merge(other.snapshot());
+	ASSERT_EQ(s.count(), 10001);
+	ASSERT_EQ(s.max().as_nanos(), 1000000000);
+	ASSERT_TRUE(near(s.p50(), 5000));
+}
+
+TEST_F(Test, HistogramTimer) {
+	Histogram h(1);
+	{
+		auto timer = h.start_timer();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	auto s = h.snapshot();
+	ASSERT_EQ(s.count(), 1);
+	ASSERT_GE(s.max().as_nanos(), 1000000);
+}